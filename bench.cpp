@@ -0,0 +1,380 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <fnmatch.h>
+#include "GetPot.hpp"
+#include "h5zio.h"
+#include "h5zio_metrics.h"
+
+using namespace std;
+
+void print_help()
+{
+    cout << "Usage: h5zio_bench [options] -i <input file>" << endl;
+    cout << "Runs every codec x error bound type x error bound value on each" << endl;
+    cout << "float/double dataset of the input file and reports rate-distortion" << endl;
+    cout << "and throughput metrics. int/long datasets run the lossless filters" << endl;
+    cout << "(gzip, intpack and the presets)" << endl;
+    cout << "Options:" << endl;
+    cout << "  -h  : Print this help message" << endl;
+    cout << "  -f <filters>: Comma separated filters (default: zfp,sz,gzip,intpack)" << endl;
+    cout << "        presets: fast, balanced, checked (shuffle + deflate 1/4, + fletcher32)" << endl;
+    cout << "  -l <level>: Deflate level of the gzip filter, 1-9 (default: 9)" << endl;
+    cout << "  -t <types>: Comma separated error bound types (default: ZFP_ACCURARY,SZ_ABSOLUTE)" << endl;
+    cout << "        types without a matching filter are ignored; gzip runs once" << endl;
+    cout << "  -e <values>: Comma separated error bound values (default: 1e-2,1e-4,1e-6)" << endl;
+    cout << "  -d <pattern>: Only datasets matching the pattern (default: *)" << endl;
+    cout << "  -o <file>: Output file, .json for JSON, CSV otherwise (default: stdout)" << endl;
+    cout << "  -n <threads>: Number of compression threads (default: 1)" << endl;
+}
+
+vector<string> split(const string& list)
+{
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while(getline(ss, item, ','))
+    {
+        if(!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// resultado de uma configuração em um dataset
+struct bench_result
+{
+    string  dataset;
+    string  type;
+    hsize_t elements;
+    string  codec;
+    string  error_bound_type;
+    double  error_bound_value;
+    double  ratio;
+    double  bits_per_value;
+    double  compress_mbs;
+    double  decompress_mbs;
+    double  max_abs_error;
+    double  rmse;
+    double  psnr;
+};
+
+template <typename T>
+bool run(const vector<T>& data, H5Dimensions& dims, H5ZIOParameters& parameters, unsigned int num_threads, bench_result& result)
+{
+    static unsigned int runs = 0;
+    const double megabyte = 1048576.0;
+    double size_mb = data.size() * sizeof(T) / megabyte;
+
+    H5Zio h5zio;
+    h5zio.set_verbose_level(0);
+    h5zio.set_num_threads(num_threads);
+    h5zio.open_memory("bench_" + to_string(runs++) + ".h5");
+
+    auto start = chrono::steady_clock::now();
+    try
+    {
+        h5zio.write_dataset<T>("data", data.data(), dims, &parameters);
+    }
+    catch(const runtime_error& e)
+    {
+        cerr << "Skipping " << result.codec << " on " << result.dataset << ": " << e.what() << endl;
+        return false;
+    }
+    double compress_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    hid_t   dataset_id = H5Dopen(h5zio.get_file_id(), "data", H5P_DEFAULT);
+    hsize_t stored     = H5Dget_storage_size(dataset_id);
+    H5Dclose(dataset_id);
+
+    vector<T> decoded;
+    start = chrono::steady_clock::now();
+    h5zio.read_dataset<T>("data", decoded);
+    double decompress_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    h5zio.close();
+
+    H5ZioMetrics metrics = H5ZIO::compute_metrics(data, decoded, num_threads);
+
+    result.ratio          = stored > 0 ? data.size() * sizeof(T) / static_cast<double>(stored) : 0.0;
+    result.bits_per_value = 8.0 * stored / data.size();
+    result.compress_mbs   = size_mb / compress_seconds;
+    result.decompress_mbs = size_mb / decompress_seconds;
+    result.max_abs_error  = metrics.get_max_abs_error();
+    result.rmse           = metrics.get_rmse();
+    result.psnr           = metrics.get_psnr();
+    return true;
+}
+
+// filtros sem perdas: os únicos aplicados a datasets inteiros
+bool is_lossless(H5ZIOParameters& parameters)
+{
+    if(parameters.get_compression_type() == H5ZIO::Type::CHAIN)
+    {
+        for(auto& step : parameters.get_filters())
+        {
+            if(step.first == H5ZIO::Filter::SCALEOFFSET) return false;
+        }
+        return true;
+    }
+    return parameters.get_compression_type() == H5ZIO::Type::GZIP || parameters.get_compression_type() == H5ZIO::Type::INTPACK;
+}
+
+// nome do codec: encadeamentos são listados filtro a filtro ("SHUFFLE+DEFLATE:4")
+string codec_name(H5ZIOParameters& parameters)
+{
+    if(parameters.get_compression_type() != H5ZIO::Type::CHAIN)
+    {
+        return H5ZIO::compression_type_names[static_cast<int>(parameters.get_compression_type())];
+    }
+    string name;
+    for(auto& step : parameters.get_filters())
+    {
+        name += (name.empty() ? "" : "+") + H5ZIO::filter_names[static_cast<int>(step.first)];
+        if(step.first == H5ZIO::Filter::DEFLATE) name += ":" + to_string(step.second);
+    }
+    return name;
+}
+
+template <typename T>
+void bench_dataset(H5Zio& input, const string& name, const string& type_name, vector<H5ZIOParameters>& grid,
+                   unsigned int num_threads, vector<bench_result>& results)
+{
+    vector<T> data;
+    H5Dimensions dims = input.read_dataset<T>(name, data);
+    if(data.empty() || dims.get_ndims() == 0)
+    {
+        return;
+    }
+    for(auto& parameters : grid)
+    {
+        bool intpack = parameters.get_compression_type() == H5ZIO::Type::INTPACK;
+        if(std::is_integral<T>::value ? !is_lossless(parameters) : intpack)
+        {
+            continue;
+        }
+        bench_result result;
+        result.dataset  = name;
+        result.type     = type_name;
+        result.elements = data.size();
+        result.codec    = codec_name(parameters);
+        if(is_lossless(parameters))
+        {
+            result.error_bound_type  = "LOSSLESS";
+            result.error_bound_value = 0.0;
+        }
+        else
+        {
+            result.error_bound_type  = H5ZIO::error_bound_names[parameters.get_error_bound_type()];
+            result.error_bound_value = parameters.get_error_bound_value();
+        }
+        if(run<T>(data, dims, parameters, num_threads, result))
+        {
+            results.push_back(result);
+        }
+    }
+}
+
+void write_csv(ostream& out, vector<bench_result>& results)
+{
+    out << "dataset,type,elements,codec,error_bound_type,error_bound_value,ratio,bits_per_value,"
+        << "compress_mbs,decompress_mbs,max_abs_error,rmse,psnr" << endl;
+    out.precision(10);
+    for(auto& r : results)
+    {
+        out << r.dataset << "," << r.type << "," << r.elements << "," << r.codec << "," << r.error_bound_type << ","
+            << r.error_bound_value << "," << r.ratio << "," << r.bits_per_value << "," << r.compress_mbs << ","
+            << r.decompress_mbs << "," << r.max_abs_error << "," << r.rmse << "," << r.psnr << endl;
+    }
+}
+
+void write_json(ostream& out, vector<bench_result>& results)
+{
+    out << "[" << endl;
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        bench_result& r = results[i];
+        out << "  {\"dataset\": \"" << r.dataset << "\", \"type\": \"" << r.type << "\", \"elements\": " << r.elements
+            << ", \"codec\": \"" << r.codec << "\", \"error_bound_type\": \"" << r.error_bound_type
+            << "\", \"error_bound_value\": " << H5ZIO::json_number(r.error_bound_value)
+            << ", \"ratio\": " << H5ZIO::json_number(r.ratio) << ", \"bits_per_value\": " << H5ZIO::json_number(r.bits_per_value)
+            << ", \"compress_mbs\": " << H5ZIO::json_number(r.compress_mbs) << ", \"decompress_mbs\": " << H5ZIO::json_number(r.decompress_mbs)
+            << ", \"max_abs_error\": " << H5ZIO::json_number(r.max_abs_error) << ", \"rmse\": " << H5ZIO::json_number(r.rmse)
+            << ", \"psnr\": " << H5ZIO::json_number(r.psnr) << "}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    out << "]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    GetPot cl(argc, argv);
+
+    if (cl.search(2, "--help", "-h") || !cl.search("-i"))
+    {
+        print_help();
+        return cl.search(2, "--help", "-h") ? 0 : 1;
+    }
+    string input_file = cl.next((const char*)"");
+
+    string filters = "zfp,sz,gzip,intpack";
+    string types   = "ZFP_ACCURARY,SZ_ABSOLUTE";
+    string values  = "1e-2,1e-4,1e-6";
+    string pattern = "*";
+    string output_file;
+    unsigned int num_threads = 1;
+    int          gzip_level  = 9;
+
+    if (cl.search(2, "--filters", "-f"))          filters     = cl.next(filters.c_str());
+    if (cl.search(2, "--error-bound-types", "-t")) types       = cl.next(types.c_str());
+    if (cl.search(2, "--error-bounds", "-e"))      values      = cl.next(values.c_str());
+    if (cl.search(2, "--datasets", "-d"))          pattern     = cl.next(pattern.c_str());
+    if (cl.search(2, "--output", "-o"))            output_file = cl.next((const char*)"");
+    if (cl.search(2, "--gzip-level", "-l"))
+    {
+        gzip_level = cl.next(9);
+        if(gzip_level < 1 || gzip_level > 9)
+        {
+            cout << "Deflate level must be between 1 and 9" << endl;
+            return 1;
+        }
+    }
+    if (cl.search(2, "--threads", "-n"))
+    {
+        int threads = cl.next(1);
+        if(threads < 1)
+        {
+            cout << "Number of threads must be positive" << endl;
+            return 1;
+        }
+        num_threads = threads;
+    }
+
+    // grade de configurações: filtro x tipo de erro x valor
+    vector<H5ZIOParameters> grid;
+    for(auto& filter : split(filters))
+    {
+        H5ZIOParameters base;
+        if(filter == "gzip" || filter == "intpack")
+        {
+            base.set_compression_type(filter == "gzip" ? H5ZIO::Type::GZIP : H5ZIO::Type::INTPACK);
+            base.set_gzip_level(gzip_level);
+            grid.push_back(base);
+            continue;
+        }
+        if(filter == "fast" || filter == "balanced" || filter == "checked")
+        {
+            base.set_filter_preset(filter == "fast" ? H5ZIO::FilterPreset::FAST :
+                                   filter == "balanced" ? H5ZIO::FilterPreset::BALANCED : H5ZIO::FilterPreset::CHECKED);
+            grid.push_back(base);
+            continue;
+        }
+        string prefix;
+        if(filter == "zfp")
+        {
+            base.set_compression_type(H5ZIO::Type::ZFP);
+            prefix = "ZFP_";
+        }
+        else if(filter == "sz")
+        {
+            base.set_compression_type(H5ZIO::Type::SZ2);
+            prefix = "SZ_";
+        }
+        else
+        {
+            cout << "Unknown filter: " << filter << endl;
+            return 1;
+        }
+        for(auto& type : split(types))
+        {
+            if(type.compare(0, prefix.size(), prefix) != 0)
+            {
+                continue;
+            }
+            bool known = false;
+            for(int i = 0; i < H5ZIO::NUM_ERROR_BOUNDS; i++)
+            {
+                known = known || type == H5ZIO::error_bound_names[i];
+            }
+            if(!known)
+            {
+                cout << "Unknown error bound type: " << type << endl;
+                return 1;
+            }
+            H5ZIOParameters typed(base);
+            typed.set_option("error_bound_type:", type);
+            if(type == "ZFP_REVERSIBLE")
+            {
+                grid.push_back(typed);
+                continue;
+            }
+            for(auto& value : split(values))
+            {
+                H5ZIOParameters configuration(typed);
+                configuration.set_error_bound_value(stod(value));
+                grid.push_back(configuration);
+            }
+        }
+    }
+
+    H5Zio input;
+    input.set_verbose_level(0);
+    input.open(input_file, "r");
+
+    vector<dataset_info> datasets;
+    vector<string>       groups;
+    input.get_datasets_info(datasets, groups);
+
+    vector<bench_result> results;
+    for(auto& dataset : datasets)
+    {
+        const string& name = dataset.first;
+        if(fnmatch(pattern.c_str(), name.c_str(), 0) != 0)
+        {
+            continue;
+        }
+        hid_t dset = H5Dopen(input.get_file_id(), name.c_str(), H5P_DEFAULT);
+        hid_t type = H5Dget_type(dset);
+        bool  is_float  = H5Tequal(type, H5T_NATIVE_FLOAT) > 0;
+        bool  is_double = H5Tequal(type, H5T_NATIVE_DOUBLE) > 0;
+        bool  is_int    = H5Tequal(type, H5T_NATIVE_INT) > 0;
+        bool  is_long   = H5Tequal(type, H5T_NATIVE_LONG) > 0;
+        H5Tclose(type);
+        H5Dclose(dset);
+
+        if(is_float)
+        {
+            bench_dataset<float>(input, name, "float", grid, num_threads, results);
+        }
+        else if(is_double)
+        {
+            bench_dataset<double>(input, name, "double", grid, num_threads, results);
+        }
+        else if(is_int)
+        {
+            bench_dataset<int>(input, name, "int", grid, num_threads, results);
+        }
+        else if(is_long)
+        {
+            bench_dataset<long>(input, name, "long", grid, num_threads, results);
+        }
+    }
+    input.close();
+
+    bool json = output_file.size() > 5 && output_file.compare(output_file.size() - 5, 5, ".json") == 0;
+    if(output_file.empty())
+    {
+        write_csv(cout, results);
+    }
+    else
+    {
+        ofstream out(output_file);
+        if(json) write_json(out, results);
+        else     write_csv(out, results);
+    }
+    return 0;
+}
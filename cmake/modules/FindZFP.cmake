@@ -21,7 +21,7 @@ FIND_PATH(ZFP_INCLUDE_DIR zfp.h
 )
 
 FIND_LIBRARY(ZFP_LIBRARY
-	NAMES ZFP
+	NAMES ZFP zfp
 	HINTS
 	$ENV{ZFP_ROOT}
 	PATH_SUFFIXES lib64 lib
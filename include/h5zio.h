@@ -8,12 +8,24 @@
 #include <type_traits>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <future>
+#include <functional>
+#include <tuple>
 
 #include "hdf5.h"
 #include "h5zio_config.h" 
+#include "h5zio_buffer.h"
+#include "h5zio_metrics.h"
+#include "h5zio_stats.h"
+#include "h5zio_trace.h"
+#include "h5zio_filter_timer.h"
+#include "h5zio_intpack.h"
 
 
 class H5ZIOParameters;
+class H5ZioPolicy;
+class H5ZioThreadPool;
 
 namespace H5ZIO {
 
@@ -35,7 +47,10 @@ namespace H5ZIO {
         NONE     = 0,
         ZFP      = 1,
         SZ2      = 2,
-        GZIP     = 3
+        GZIP     = 3,
+        AUTO     = 4,   // escolhido por dataset entre os compressores disponíveis (H5ZioTuner::select_codec)
+        INTPACK  = 5,   // inteiros sem perdas: delta, zig-zag, referência e empacotamento de bits (h5zio_intpack.h)
+        CHAIN    = 6    // encadeamento de filtros do HDF5 definido com H5ZIOParameters::add_filter
     };
     namespace SZ2
     {
@@ -68,18 +83,104 @@ namespace H5ZIO {
 
     }
 
-    // armazena os valores de erro default para cada tipo de erro
-    static  double error_bound_values[]     = {1.0E-6, 1.0E-3, 1.0E-5, 1.0E-5, 1.0E-5, 1.0E-2, 1.0E-6};
+    // número de tipos de erro (SZ2 e ZFP)
+    const   int    NUM_ERROR_BOUNDS = 8;
+
+    // valores de erro default para cada tipo de erro; cada H5ZIOParameters guarda a sua cópia
+    const   double default_error_bound_values[NUM_ERROR_BOUNDS] = {1.0E-6, 1.0E-3, 1.0E-5, 1.0E-5, 1.0E-5, 1.0E-2, 1.0E-6, 0.0};
     //                                         0               1             2                 3                4           5                 6               7
     static  std::string error_bound_names[] = {"SZ_ABSOLUTE", "SZ_RELATIVE", "SZ_ABS_AND_REL", "SZ_ABS_OR_REL", "SZ_PSNR", "SZ_PW_RELATIVE", "ZFP_ACCURARY", "ZFP_REVERSIBLE"};
     
     // armaze os ids dos erros do SZ2
     static  int  error_ids[]                = {0, 1, 2, 3, 4, 10, 6};
     
-    static  std::string compression_type_names[] = {"NONE", "ZFP", "SZ2.1", "GZIP"};
+    static  std::string compression_type_names[] = {"NONE", "ZFP", "SZ2.1", "GZIP", "AUTO", "INTPACK", "CHAIN"};
+
+    /**
+     * @brief enum class que define os filtros predefinidos do HDF5 que compõem
+     *        um encadeamento (H5ZIO::Type::CHAIN). O argumento de cada filtro:
+     *          SHUFFLE     : -
+     *          DEFLATE     : nível de 1 a 9 (0: o de set_gzip_level)
+     *          SCALEOFFSET : inteiros: largura mínima em bits (0: calculada por chunk);
+     *                        ponto flutuante: casas decimais preservadas (com perdas),
+     *                        obrigatório: 0 é rejeitado ao criar o dataset
+     *          NBIT        : - (só reduz tipos com precisão menor que o tamanho)
+     *          FLETCHER32  : - (checksum verificado na leitura)
+     */
+    enum class Filter:int {
+        SHUFFLE     = 0,
+        DEFLATE     = 1,
+        SCALEOFFSET = 2,
+        NBIT        = 3,
+        FLETCHER32  = 4
+    };
+    static  std::string filter_names[] = {"SHUFFLE", "DEFLATE", "SCALEOFFSET", "NBIT", "FLETCHER32"};
+
+    // um filtro de um encadeamento e o seu argumento
+    typedef std::pair<Filter, int> FilterStep;
+
+    /**
+     * @brief enum class que define os encadeamentos predefinidos (H5ZIOParameters::set_filter_preset).
+     *        Em conectividades, índices e campos float/double, o shuffle antes do deflate 
+     *        aumenta a taxa de compressão e a vazão em relação ao deflate sozinho; acima 
+     *        do nível 4 o ganho de taxa é pequeno e a gravação fica mais lenta.
+     *        O scale-offset antes do shuffle reduz a taxa nesses dados
+     * 
+     */
+    enum class FilterPreset:int {
+        FAST     = 0,   // shuffle + deflate 1
+        BALANCED = 1,   // shuffle + deflate 4
+        CHECKED  = 2    // shuffle + deflate 4 + fletcher32
+    };
+
+    /**
+     * @brief enum class que define como o formato dos chunks é escolhido
+     * 
+     */
+    enum class ChunkMode:int {
+        AUTO     = 0,   // formato planejado a partir do tamanho alvo em bytes
+        EXPLICIT = 1,   // formato definido pelo usuário
+        SINGLE   = 2    // um único chunk com o dataset inteiro (limitado a MAX_CHUNK_SIZE)
+    };
+
+    // limite do HDF5 para o tamanho de um chunk em bytes (2^32-1)
+    const hsize_t MAX_CHUNK_SIZE     = 4294967295ULL;
+    // tamanho alvo default de um chunk em bytes
+    const hsize_t DEFAULT_CHUNK_SIZE = 16777216ULL;
+
+    // incremento de memória do driver core em arquivos em memória (16 MB)
+    const size_t CORE_INCREMENT = 16777216;
+
+    // limite default de memória usado por compress (256 MB)
+    const hsize_t DEFAULT_MEMORY_BUDGET = 268435456ULL;
+
+    /**
+     * @brief enum class que define a que tipos de elementos uma regra de H5ZioPolicy se aplica
+     * 
+     */
+    enum class Elements:int {
+        ANY     = 0,
+        FLOAT   = 1,    // float e double
+        INTEGER = 2     // tipos inteiros e char
+    };
 
-    // Rotina que converte um arquivo h5 com dados brutos para um arquivo h5 com compressão
-    void compress(const std::string& input_file, const std::string& output_file, H5ZIOParameters& parameters);
+    // Rotina que converte um arquivo h5 com dados brutos para um arquivo h5 com compressão.
+    // Datasets maiores que memory_budget são lidos e gravados por blocos de chunks.
+    // Com mais de uma thread, a leitura, a compressão e a gravação dos blocos se sobrepõem.
+    // Inteiros e reais em outra ordem de bytes são gravados com o tipo nativo; os demais tipos
+    // (strings, compostos, enums, arrays) são copiados sem compressão e com o tipo original
+    void compress(const std::string& input_file, const std::string& output_file, H5ZIOParameters& parameters, 
+                  hsize_t memory_budget = DEFAULT_MEMORY_BUDGET, unsigned int num_threads = 1);
+
+    // O mesmo, com os parâmetros de cada dataset escolhidos pela política
+    void compress(const std::string& input_file, const std::string& output_file, H5ZioPolicy& policy, 
+                  hsize_t memory_budget = DEFAULT_MEMORY_BUDGET, unsigned int num_threads = 1);
+
+    // Rotina inversa: regrava um arquivo comprimido com datasets contíguos e sem filtros,
+    // mantendo grupos e tipos. Os chunks de cada bloco são decodificados em paralelo e o
+    // bloco, alinhado aos chunks da entrada, é gravado com um único H5Dwrite
+    void decompress(const std::string& input_file, const std::string& output_file, unsigned int num_threads = 1, 
+                    hsize_t memory_budget = DEFAULT_MEMORY_BUDGET);
 
 }
 
@@ -155,14 +256,181 @@ class H5ZIOParameters
         int    get_sz_error_bound_id();
         int    get_gzip_level();
 
+        // nível do deflate usado por H5ZIO::Type::GZIP (1 a 9)
+        void   set_gzip_level(int level);
+
+        /**
+         * @brief Acrescenta um filtro ao encadeamento e seleciona H5ZIO::Type::CHAIN.
+         *        Os filtros são aplicados na ordem em que são adicionados; 
+         *        SCALEOFFSET e NBIT dependem do tipo dos elementos e devem 
+         *        preceder SHUFFLE e DEFLATE
+         * 
+         * @param filter   : filtro
+         * @param argument : argumento do filtro (H5ZIO::Filter)
+         * @return os próprios parâmetros, para encadear chamadas
+         */
+        H5ZIOParameters& add_filter(H5ZIO::Filter filter, int argument = 0);
+        void             clear_filters();
+        const std::vector<H5ZIO::FilterStep>& get_filters() const {return filters;}
+
+        // substitui o encadeamento por um predefinido e seleciona H5ZIO::Type::CHAIN
+        void set_filter_preset(H5ZIO::FilterPreset preset);
+
+        /**
+         * @brief Define explicitamente o formato dos chunks (ChunkMode::EXPLICIT)
+         * 
+         * @param ndims      : número de dimensões
+         * @param chunk_dims : dimensões do chunk
+         */
+        void set_chunk_dimensions(hsize_t ndims, const hsize_t chunk_dims[]);
+
+        /**
+         * @brief Define o tamanho alvo dos chunks em bytes (ChunkMode::AUTO)
+         * 
+         * @param bytes : tamanho alvo, limitado a H5ZIO::MAX_CHUNK_SIZE
+         */
+        void set_chunk_size(hsize_t bytes);
+        void set_chunk_mode(H5ZIO::ChunkMode mode);
+
+        H5ZIO::ChunkMode get_chunk_mode();
+        hsize_t get_chunk_size();
+
+        /**
+         * @brief Define a vazão mínima de compressão, em MB/s, exigida do 
+         *        compressor escolhido com H5ZIO::Type::AUTO (0: sem limite)
+         * 
+         * @param mb_per_second 
+         */
+        void   set_min_throughput(double mb_per_second);
+        double get_min_throughput();
+
+        /**
+         * @brief Ativa a verificação na escrita: cada chunk codificado é 
+         *        decodificado no pool de threads e comparado com o original.
+         *        Chunks que violam o limite de erro são gravados sem o filtro
+         *        (sem perdas) e um resumo é gravado nos atributos do dataset
+         * 
+         * @param enabled 
+         */
+        void set_verify(bool enabled);
+        bool get_verify();
+
+        /**
+         * @brief Calcula o formato dos chunks de um dataset.
+         *        No modo automático as dimensões são múltiplas do bloco 
+         *        preferido pelo compressor (4^d no ZFP) e o chunk 
+         *        não ultrapassa o tamanho alvo nem H5ZIO::MAX_CHUNK_SIZE
+         * 
+         * @param ndims      : número de dimensões do dataset
+         * @param dims       : dimensões do dataset
+         * @param type_size  : tamanho em bytes de um elemento
+         * @param chunk_dims : [saída] dimensões do chunk
+         */
+        void plan_chunk_dimensions(hsize_t ndims, const hsize_t dims[], hsize_t type_size, hsize_t chunk_dims[]);
+
         void save_config(const std::string& filename);
         void load_config(const std::string& filename);
+
+        /**
+         * @brief Define um parâmetro a partir de uma linha "chave: valor" do 
+         *        arquivo de configuração
+         * 
+         * @return false se a chave não for reconhecida
+         */
+        bool set_option(const std::string& key, const std::string& value);
+
+        /**
+         * @brief Compara e calcula o hash de todos os parâmetros, inclusive os 
+         *        valores de erro de cada tipo, permitindo usar os parâmetros 
+         *        como chave de caches e de varreduras de configurações
+         */
+        bool   operator==(const H5ZIOParameters& other) const;
+        bool   operator!=(const H5ZIOParameters& other) const {return !(*this == other);}
+        size_t hash() const;
         
     private:
+
+        hsize_t block_edge(hsize_t ndims);
+
         // Lossless compression parameters
         H5ZIO::Type type;    
         int error_bound_type;    
         int gzip_level;
+        double error_bound_values[H5ZIO::NUM_ERROR_BOUNDS];
+        std::vector<H5ZIO::FilterStep> filters;
+
+        // Chunking parameters
+        H5ZIO::ChunkMode     chunk_mode;
+        hsize_t              chunk_size;
+        std::vector<hsize_t> chunk_dims;
+
+        // Codec selection parameters
+        double min_throughput;
+
+        // Verification parameters
+        bool verify;
+};
+
+namespace std {
+    template <>
+    struct hash<H5ZIOParameters>
+    {
+        size_t operator()(const H5ZIOParameters& parameters) const {return parameters.hash();}
+    };
+}
+
+/**
+ * @brief Associa padrões de caminho de datasets e tipos de elementos a parâmetros 
+ *        de compressão. As regras são avaliadas na ordem em que foram adicionadas e
+ *        a primeira que casar com o dataset é usada; sem regra, valem os parâmetros 
+ *        default do tipo (inteiros não são comprimidos por default; H5ZIO::Type::INTPACK
+ *        é escolhido com set_default(..., H5ZIO::Elements::INTEGER) ou por regra).
+ *        Os padrões seguem fnmatch: '*' casa com qualquer sequência, inclusive '/'
+ * 
+ */
+class H5ZioPolicy
+{
+    public:
+        H5ZioPolicy();
+
+        void set_default(const H5ZIOParameters& parameters, H5ZIO::Elements elements = H5ZIO::Elements::FLOAT);
+        void add_rule(const std::string& pattern, const H5ZIOParameters& parameters, H5ZIO::Elements elements = H5ZIO::Elements::ANY);
+
+        /**
+         * @brief Obtém os parâmetros de um dataset
+         * 
+         * @param dataset  : caminho do dataset
+         * @param floating : indica se os elementos são float ou double
+         * @return H5ZIOParameters* : parâmetros, ou nullptr se o dataset não deve ser comprimido
+         */
+        H5ZIOParameters* find(const std::string& dataset, bool floating);
+
+        /**
+         * @brief Lê a política de um arquivo de configuração. As linhas antes da 
+         *        primeira seção definem os parâmetros default de ponto flutuante; 
+         *        cada seção "[padrão]" ou "[padrão float|integer]" cria uma regra 
+         *        que parte desses parâmetros ('*' também casa com '/'):
+         * 
+         *            compression_type: ZFP
+         *            [/Mesh*]
+         *            compression_type: GZIP
+         *            [/Function/pressure* float]
+         *            compression_type: SZ2.1
+         *            error_bound_type: SZ_RELATIVE
+         *            error_bound_value: 1e-4
+         * 
+         * @param filename 
+         */
+        void load_config(const std::string& filename);
+
+        size_t size() {return rules.size();}
+
+    private:
+        typedef std::tuple<std::string, H5ZIO::Elements, H5ZIOParameters> rule;
+
+        std::vector<rule> rules;
+        H5ZIOParameters   float_default;
+        H5ZIOParameters   integer_default;
 };
 
 /**
@@ -188,6 +456,18 @@ class H5ZioAttribute
 
 };
 
+/**
+ * @brief Resumo da verificação na escrita de um dataset (H5ZIOParameters::set_verify)
+ * 
+ */
+struct H5ZioVerifySummary
+{
+    H5ZioVerifySummary() : chunks(0), lossless(0) {}
+    hsize_t      chunks;     // chunks verificados
+    hsize_t      lossless;   // chunks que violaram o limite e foram gravados sem o filtro
+    H5ZioMetrics metrics;    // erro dos dados gravados
+};
+
 /**
  * @brief Classe especializada em leitura e escrita de arquivos h5 
  *        com suporte a compressão de dados
@@ -200,6 +480,9 @@ class H5Zio
         H5Zio();
         ~H5Zio();
 
+        H5Zio(const H5Zio&) = delete;
+        H5Zio& operator=(const H5Zio&) = delete;
+
         /**
          * @brief Open um arquivo h5 para leitura ou escrita
          * 
@@ -208,6 +491,34 @@ class H5Zio
          */
         void open(const std::string &filename, std::string mode = "a");
 
+        /**
+         * @brief Cria um arquivo h5 em memória (driver core do HDF5). Os datasets 
+         *        e metadados são gravados na RAM; com backing_store o arquivo é 
+         *        gravado em disco de uma só vez no fechamento
+         * 
+         * @param filename      : nome do arquivo (usado em disco se backing_store)
+         * @param backing_store : grava o arquivo em disco no fechamento
+         */
+        void open_memory(const std::string &filename, bool backing_store = false);
+
+        /**
+         * @brief Abre para leitura um arquivo h5 armazenado em um buffer.
+         *        O conteúdo do buffer é copiado pelo HDF5
+         * 
+         * @param buffer : imagem do arquivo
+         * @param size   : tamanho da imagem em bytes
+         */
+        void open_image(const void* buffer, size_t size);
+        void open_image(const std::vector<unsigned char>& image) {open_image(image.data(), image.size());}
+
+        /**
+         * @brief Obtém a imagem do arquivo aberto como um buffer contíguo,
+         *        que pode ser enviado e aberto com open_image
+         * 
+         * @return std::vector<unsigned char> : conteúdo do arquivo
+         */
+        std::vector<unsigned char> get_image();
+
         /**
          * @brief Escreve um dataset no arquivo h5
          * 
@@ -240,6 +551,116 @@ class H5Zio
         template <typename T>
         void write_dataset(std::string dataset, const std::vector<T>& data, H5Dimensions &dims, H5ZIOParameters* parameters, H5ZioAttribute* attributes = nullptr);
 
+        /**
+         * @brief Escreve um dataset em segundo plano. A compressão e a gravação
+         *        rodam em uma thread de I/O, na ordem de submissão, enquanto quem 
+         *        chama continua executando. O vetor passa a pertencer à escrita.
+         *        Enquanto houver escritas pendentes, somente write_dataset_async,
+         *        flush e close podem ser chamados
+         * 
+         * @tparam T         : tipo dos dados
+         * @param dataset    : nome do dataset
+         * @param data       : dados (movidos)
+         * @param ndims      : número de dimensões
+         * @param dims       : dimensões
+         * @param parameters : parâmetros de compressão (copiados)
+         * @param attributes : atributos do dataset (copiados)
+         * @return std::future<void> : conclusão da escrita; erros são relançados em get()
+         */
+        template <typename T>
+        std::future<void> write_dataset_async(std::string dataset, std::vector<T>&& data, hsize_t ndims, const hsize_t dims[], 
+                                              H5ZIOParameters* parameters = nullptr, H5ZioAttribute* attributes = nullptr);
+
+        /**
+         * @brief Escreve um dataset em segundo plano. Os dados são copiados para
+         *        um buffer do pool e podem ser modificados logo após o retorno
+         */
+        template <typename T>
+        std::future<void> write_dataset_async(std::string dataset, const T* data, hsize_t ndims, const hsize_t dims[], 
+                                              H5ZIOParameters* parameters = nullptr, H5ZioAttribute* attributes = nullptr);
+
+        /**
+         * @brief Aguarda as escritas em segundo plano e grava os buffers do HDF5 no arquivo
+         * 
+         */
+        void flush();
+
+        /**
+         * @brief Cria um dataset sem gravar dados. Os dados podem ser 
+         *        gravados por partes com write_region
+         * 
+         * @tparam T         : tipo dos dados
+         * @param dataset    : nome do dataset
+         * @param ndims      : número de dimensões
+         * @param dims       : dimensões
+         * @param parameters : parâmetros de compressão
+         * @param attributes : atributos do dataset
+         */
+        template <typename T>
+        void create_dataset(std::string dataset, hsize_t ndims, const hsize_t dims[], H5ZIOParameters* parameters = nullptr, H5ZioAttribute* attributes = nullptr);
+
+        /**
+         * @brief Grava uma região (hyperslab) de um dataset existente.
+         *        Regiões alinhadas aos chunks evitam que chunks comprimidos 
+         *        sejam lidos e regravados
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @param offset   : posição inicial da região em cada dimensão
+         * @param count    : número de elementos gravados em cada dimensão
+         * @param data     : dados da região
+         */
+        template <typename T>
+        void write_region(std::string dataset, const hsize_t offset[], const hsize_t count[], const T* data);
+
+        /**
+         * @brief Copia um dataset de outro arquivo, aplicando os parâmetros de 
+         *        compressão. O dataset é processado em blocos de chunks que usam 
+         *        no máximo memory_budget bytes. Com mais de uma thread, o bloco 
+         *        seguinte é lido enquanto o atual é comprimido no pool e os 
+         *        chunks do anterior são gravados
+         * 
+         * @tparam T            : tipo dos dados
+         * @param input         : arquivo de origem, aberto para leitura
+         * @param dataset       : nome do dataset (o mesmo nos dois arquivos)
+         * @param parameters    : parâmetros de compressão
+         * @param memory_budget : limite de memória em bytes
+         */
+        template <typename T>
+        void copy_dataset(H5Zio& input, std::string dataset, H5ZIOParameters* parameters, hsize_t memory_budget = H5ZIO::DEFAULT_MEMORY_BUDGET);
+
+        /**
+         * @brief Cria uma série temporal: um dataset cuja primeira dimensão 
+         *        (o tempo) é ilimitada e cresce a cada chamada de append.
+         *        Cada chunk contém um único passo de tempo
+         * 
+         * @tparam T         : tipo dos dados
+         * @param dataset    : nome do dataset
+         * @param ndims      : número de dimensões de um passo de tempo
+         * @param dims       : dimensões de um passo de tempo
+         * @param parameters : parâmetros de compressão
+         * @param attributes : atributos do dataset
+         */
+        template <typename T>
+        void create_timeseries(std::string dataset, hsize_t ndims, const hsize_t dims[], H5ZIOParameters* parameters = nullptr, H5ZioAttribute* attributes = nullptr);
+
+        template <typename T>
+        void create_timeseries(std::string dataset, H5Dimensions& dims, H5ZIOParameters* parameters = nullptr, H5ZioAttribute* attributes = nullptr);
+
+        /**
+         * @brief Acrescenta um passo de tempo a uma série temporal, 
+         *        gravando somente os chunks do novo passo
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @param data     : dados do passo de tempo
+         */
+        template <typename T>
+        void append(std::string dataset, const T* data);
+
+        template <typename T>
+        void append(std::string dataset, const std::vector<T>& data);
+
         /**
          * @brief Obtem as dimensões de um dataset de um arquivo.
          *        Deve ser usado somente se o arquivo estiver aberto em modo de leitura
@@ -267,8 +688,77 @@ class H5Zio
          * @param data     : vetor para armazenar os dados
          * @return H5Dimensions : dimensões do dataset
          */
-        template <typename T> 
-        H5Dimensions read_dataset(std::string dataset, std::vector<T>& data);
+        template <typename T, typename Allocator> 
+        H5Dimensions read_dataset(std::string dataset, std::vector<T, Allocator>& data);
+
+        /**
+         * @brief Faz a leitura de um dataset em um buffer alinhado do pool desta 
+         *        instância. O buffer não é inicializado antes da leitura e volta 
+         *        ao pool quando a view é destruída, de forma que leituras 
+         *        repetidas de campos do mesmo tamanho não alocam memória
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @return H5ZioView<T> : dados e dimensões do dataset
+         */
+        template <typename T>
+        H5ZioView<T> read_view(std::string dataset);
+
+        /**
+         * @brief Mapeia um dataset diretamente do arquivo, sem cópia. Somente 
+         *        datasets contíguos, sem filtros e cujo tipo no arquivo é igual 
+         *        a T são mapeados; os demais são lidos com read_view. O arquivo 
+         *        deve estar aberto em modo de leitura. O mapeamento é somente leitura
+         *        e a view só dá acesso constante aos dados, mapeados ou copiados
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @return H5ZioView<const T> : dados e dimensões do dataset
+         */
+        template <typename T>
+        H5ZioView<const T> map_view(std::string dataset);
+
+        // pool de buffers usado por read_view
+        H5ZioBufferPool& buffer_pool() {return *buffers;}
+
+        /**
+         * @brief Faz a leitura de uma região (hyperslab) de um dataset.
+         *        Somente os chunks que interceptam a região são descomprimidos
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @param offset   : posição inicial da região em cada dimensão
+         * @param count    : número de elementos lidos em cada dimensão
+         * @param stride   : passo em cada dimensão (nullptr para passo unitário)
+         * @param data     : ponteiro para os dados (produto de count elementos)
+         */
+        template <typename T>
+        void read_region(std::string dataset, const hsize_t offset[], const hsize_t count[], const hsize_t stride[], T* data);
+
+        template <typename T>
+        void read_region(std::string dataset, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, T* data);
+
+        /**
+         * @brief Faz a leitura de uma região (hyperslab) de um dataset
+         * 
+         * @tparam T       : tipo dos dados
+         * @param dataset  : nome do dataset
+         * @param offset   : posição inicial da região em cada dimensão
+         * @param count    : número de elementos lidos em cada dimensão
+         * @param stride   : passo em cada dimensão (vazio para passo unitário)
+         * @return std::vector<T> : dados da região
+         */
+        template <typename T>
+        std::vector<T> read_region(std::string dataset, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, 
+                                   const std::vector<hsize_t>& stride = std::vector<hsize_t>());
+
+        /**
+         * @brief Grava atributos em um dataset existente
+         * 
+         * @param dataset    : nome do dataset
+         * @param attributes : atributos
+         */
+        void write_attributes(std::string dataset, H5ZioAttribute* attributes);
 
         /**
          * @brief Fecha o arquivo h5
@@ -285,6 +775,16 @@ class H5Zio
          */
         void set_verbose_level(int level) {verbose_level = level;};
 
+        /**
+         * @brief Define o número de threads usadas na compressão e descompressão.
+         *         Com mais de uma thread, os chunks de datasets comprimidos são 
+         *         codificados em paralelo e gravados com H5Dwrite_chunk, e na 
+         *         leitura são obtidos com H5Dread_chunk e decodificados em paralelo
+         * @param nthreads 
+         */
+        void set_num_threads(unsigned int nthreads) {num_threads = nthreads > 0 ? nthreads : 1;};
+        unsigned int get_num_threads() {return num_threads;}
+
 
         /**
          * @brief Extrai informações dos datasets de um arquivo h5
@@ -296,16 +796,74 @@ class H5Zio
 
         hid_t get_file_id() {return file_id;}
 
+        /**
+         * @brief Estatísticas de escrita e leitura por dataset desta instância: bytes
+         *        sem compressão e armazenados, tempo de criação dos filtros, de 
+         *        H5Dwrite/H5Dread, de compressão e de metadados e pico de memória 
+         *        em buffers. Acumuladas entre arquivos até get_stats().clear()
+         */
+        H5ZioStats& get_stats() {return stats;}
+
+        /**
+         * @brief Mede os filtros por chunk (tempo, bytes de entrada e saída e número de
+         *        chunks) nos campos filter_* das estatísticas. No caminho de chunks diretos
+         *        (set_num_threads > 1) é medida a codificação feita pelo pool, para qualquer
+         *        filtro. Em H5Dwrite/H5Dread, somente os filtros do h5zio (INTPACK), cuja
+         *        classe é registrada de novo com H5Zregister; o tempo do deflate, do shuffle
+         *        e dos plugins fica em io_seconds. Ao desligar (ou destruir o objeto), as
+         *        classes originais são restauradas quando nenhum outro H5Zio mede filtros
+         * @param enable 
+         */
+        void set_filter_timing(bool enable);
+        bool get_filter_timing() {return filter_timing;}
+
         void create_groups(std::vector<std::string> &groups);
        
     private:
 
-        hid_t create_filter(H5ZIOParameters* params, hsize_t ndims, hsize_t dims[]);
+        /**
+         * @brief Obtém a lista de propriedades de criação para os parâmetros. 
+         *        As listas ficam em cache até o fechamento do arquivo e não 
+         *        devem ser fechadas por quem chama
+         */
+        hid_t create_filter(H5ZIOParameters* params, hid_t type, hsize_t ndims, hsize_t dims[], hsize_t type_size, 
+                            const hsize_t chunk_dims[] = nullptr);
+        hid_t build_filter(H5ZIOParameters* params, hid_t type, hsize_t ndims, const hsize_t chunk[]);
+        void  write_attributes(hid_t dataset_id, H5ZioAttribute* attributes);
+        hid_t open_new_dataset(std::string dataset, hid_t type, hsize_t type_size, hsize_t ndims, const hsize_t dims[], 
+                               H5ZIOParameters* parameters);
+        void  write_region(hid_t dataset_id, hid_t type, hsize_t type_size, const hsize_t offset[], const hsize_t count[], const void* data,
+                           H5ZioDatasetStats* record = nullptr);
+        void  create_extendible(std::string dataset, hid_t type, hsize_t type_size, hsize_t ndims, const hsize_t dims[], 
+                                H5ZIOParameters* parameters, H5ZioAttribute* attributes);
+        void  copy_blocks(H5Zio& input, std::string dataset, hid_t type, hsize_t type_size, hsize_t memory_budget, 
+                          H5ZIOParameters* verify, H5ZioDatasetStats& record);
+        void  append_step(std::string dataset, hid_t type, hsize_t type_size, const void* data, hsize_t nelements = 0);
         template <typename T> hid_t    h5_type();
         template <typename T> hsize_t type_size();
 
         void create_groups(const std::string& path);
 
+        H5ZioThreadPool& thread_pool();
+        std::future<void> submit_io(std::function<void()> task);
+        bool write_chunks(hid_t dataset_id, const void* data, hsize_t ndims, const hsize_t dims[], const hsize_t start[] = nullptr,
+                          H5ZIOParameters* verify = nullptr, H5ZioVerifySummary* summary = nullptr, 
+                          H5ZioDatasetStats* record = nullptr);
+        void write_verify_summary(hid_t dataset_id, H5ZioVerifySummary& summary);
+        bool verify_chunks(hid_t dataset_id, hid_t type, const void* data, hsize_t ndims, const hsize_t dims[], const hsize_t start[],
+                           H5ZIOParameters& parameters, H5ZioVerifySummary& summary);
+        bool read_chunks(hid_t dataset_id, hid_t mem_type, void* data, const hsize_t start[] = nullptr, const hsize_t count[] = nullptr,
+                         H5ZioDatasetStats* record = nullptr);
+        void read_region(hid_t dataset_id, hid_t mem_type, const hsize_t offset[], const hsize_t count[], const hsize_t stride[], void* data);
+        hid_t        open_dataset(std::string dataset);
+        H5Dimensions dataset_dimensions(hid_t dataset_id);
+        void*        map_dataset(hid_t dataset_id, hid_t mem_type, size_t bytes, void*& base, size_t& length);
+        void         read_dataset(hid_t dataset_id, hid_t mem_type, void* data);
+        // registra uma operação com o caminho absoluto do dataset
+        void         add_stats(const std::string& dataset, const std::string& operation, H5ZioDatasetStats& record);
+        // registro que recebe a medição dos filtros do dataset, ou nullptr sem set_filter_timing
+        H5ZioDatasetStats* filter_record(hid_t dataset_id, H5ZioDatasetStats& record);
+
         std::string file_name;
         hid_t       file_id;
         bool         is_open;
@@ -314,6 +872,20 @@ class H5Zio
 
         hsize_t total_storage_size;
         hsize_t total_input_data_size;
+
+        unsigned int                     num_threads;
+        std::unique_ptr<H5ZioThreadPool> workers;
+        std::shared_ptr<H5ZioBufferPool> buffers;
+
+        // (compressor, tipo de erro, nível do gzip, valores de erro, formato dos chunks)
+        typedef std::tuple<int, int, int, std::vector<double>, std::vector<hsize_t>, std::vector<H5ZIO::FilterStep>, int> filter_key;
+        std::map<filter_key, hid_t> filter_cache;
+
+        H5ZioStats stats;
+        bool       filter_timing;
+
+        // thread de I/O das escritas assíncronas; destruída antes dos demais membros
+        std::unique_ptr<H5ZioThreadPool> io_worker;
  
 
 };  
@@ -337,6 +909,10 @@ hsize_t H5Zio::type_size()
     {
         return sizeof(char);
     }
+    if(std::is_same<T, signed char>::value)
+    {
+        return sizeof(signed char);
+    }
     if(std::is_same<T, long>::value)
     {
         return sizeof(long);
@@ -400,6 +976,10 @@ hsize_t H5Zio::type_size()
         {
             return H5T_NATIVE_CHAR;
         }
+        if(std::is_same<T, signed char>::value)
+        {
+            return H5T_NATIVE_SCHAR;
+        }
         if(std::is_same<T, long>::value)
         {
             return H5T_NATIVE_LONG;
@@ -450,15 +1030,9 @@ void H5Zio::write_dataset(std::string dataset, const T* data, hsize_t ndims,  hs
     {
         throw std::runtime_error("File is not open");
     }
-    hid_t dataspace_id, dataset_id, filter_id = H5P_DEFAULT;
+    hid_t dataset_id;
     hsize_t h5dims[ndims];
 
-    if(parameters != nullptr)
-    {
-        filter_id = create_filter(parameters, ndims, dims);
-    }
-    
-
     hsize_t data_size = 1;
     for(int i = 0; i < ndims; i++)
     {
@@ -468,35 +1042,43 @@ void H5Zio::write_dataset(std::string dataset, const T* data, hsize_t ndims,  hs
 
     total_input_data_size += data_size * type_size<T>();
 
-    dataspace_id = H5Screate_simple(ndims, h5dims, NULL);
-    if(dataspace_id < 0)
+    H5ZIO_TRACE("H5Zio::write_dataset");
+    H5ZioDatasetStats record;
+    H5ZioTimer        wall, timer;
+    record.calls     = 1;
+    record.raw_bytes = data_size * type_size<T>();
+
+    dataset_id = open_new_dataset(dataset, h5_type<T>(), type_size<T>(), ndims, h5dims, parameters);
+    H5ZioFilterScope filters(filter_record(dataset_id, record));
+    record.setup_seconds = timer.lap();
+    // se a gravação, a verificação ou os atributos falharem, o dataset é fechado antes de propagar
+    // o erro (o dcpl pertence ao cache de create_filter)
+    hsize_t storage_size;
+    try
     {
-        throw std::runtime_error("Failed to create dataspace");
-    }
+        // caminho paralelo, ou com verificação: chunks codificados fora do HDF5 e gravados diretamente
+        bool               verify = parameters != nullptr && parameters->get_verify();
+        H5ZioVerifySummary summary;
+        if(parameters == nullptr || (num_threads < 2 && !verify) || 
+           !write_chunks(dataset_id, data, ndims, h5dims, nullptr, verify ? parameters : nullptr, &summary, &record))
+        {
+            H5ZIO_TRACE("H5Dwrite");
+            H5Dwrite(dataset_id, h5_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+            record.io_seconds += timer.lap();
+            // filtros sem codificação direta: os chunks gravados são lidos de volta
+            if(verify) verify_chunks(dataset_id, h5_type<T>(), data, ndims, h5dims, nullptr, *parameters, summary);
+        }
+        timer.lap();
+        if(verify) write_verify_summary(dataset_id, summary);
+        storage_size         = H5Dget_storage_size(dataset_id);
+        record.stored_bytes  = storage_size;
 
-    // write dataset attributes
-    dataset_id = H5Dcreate2(file_id, dataset.c_str(), h5_type<T>(), dataspace_id, H5P_DEFAULT, filter_id, H5P_DEFAULT);
-    if(dataset_id < 0)
-    {
-        throw std::runtime_error("Failed to create dataset");
+        write_attributes(dataset_id, attributes);
     }
-    H5Dwrite(dataset_id, h5_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
-    hsize_t storage_size = H5Dget_storage_size(dataset_id);
-
-    if(attributes != nullptr)
+    catch(...)
     {
-        for(int i = 0; i < attributes->size(); i++)
-        {
-            auto attribute = attributes->get_attribute(i);
-            hid_t attribute_id   = H5Screate(H5S_SCALAR);
-            hid_t attribute_type = H5Tcopy(H5T_C_S1);
-            H5Tset_size(attribute_type, attribute.second.size());
-            hid_t att_id = H5Acreate2(dataset_id, attribute.first.c_str(), attribute_type, attribute_id, H5P_DEFAULT, H5P_DEFAULT);
-            H5Awrite(att_id, attribute_type, attribute.second.c_str());
-            H5Aclose(att_id);
-            H5Tclose(attribute_type);
-            H5Sclose(attribute_id);
-        }
+        H5Dclose(dataset_id);
+        throw;
     }
 
     if(verbose_level > 1)
@@ -510,8 +1092,13 @@ void H5Zio::write_dataset(std::string dataset, const T* data, hsize_t ndims,  hs
 
     total_storage_size += storage_size;
 
-    H5Dclose(dataset_id);
-    H5Sclose(dataspace_id);
+    {
+        H5ZIO_TRACE("H5Dclose");
+        H5Dclose(dataset_id);
+    }
+    record.metadata_seconds = timer.lap();
+    record.wall_seconds     = wall.lap();
+    add_stats(dataset, "write", record);
 }
 
 template <typename T>
@@ -548,6 +1135,45 @@ void H5Zio::write_dataset(std::string dataset, const std::vector<T>& data, H5Dim
     write_dataset(dataset, data.data(), dims.get_ndims(), dims.get_dims(), parameters, attributes);
 }
 
+template <typename T>
+std::future<void> H5Zio::write_dataset_async(std::string dataset, std::vector<T>&& data, hsize_t ndims, const hsize_t dims[], 
+                                             H5ZIOParameters* parameters, H5ZioAttribute* attributes)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    std::vector<hsize_t> shape(dims, dims + ndims);
+    if(H5Dimensions(ndims, shape.data()).total_size() != data.size())
+    {
+        throw std::runtime_error("Data size does not match the dataset dimensions");
+    }
+    auto buffer = std::make_shared<std::vector<T> >(std::move(data));
+    std::shared_ptr<H5ZIOParameters> params(parameters != nullptr ? new H5ZIOParameters(*parameters) : nullptr);
+    std::shared_ptr<H5ZioAttribute>  attrs(attributes != nullptr ? new H5ZioAttribute(*attributes) : nullptr);
+    return submit_io([this, dataset, buffer, shape, params, attrs]() mutable {
+        write_dataset<T>(dataset, buffer->data(), shape.size(), shape.data(), params.get(), attrs.get());
+    });
+}
+
+template <typename T>
+std::future<void> H5Zio::write_dataset_async(std::string dataset, const T* data, hsize_t ndims, const hsize_t dims[], 
+                                             H5ZIOParameters* parameters, H5ZioAttribute* attributes)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    std::vector<hsize_t> shape(dims, dims + ndims);
+    auto buffer = std::make_shared<H5ZioView<T> >(buffers, H5Dimensions(ndims, shape.data()).total_size());
+    std::copy(data, data + buffer->size(), buffer->data());
+    std::shared_ptr<H5ZIOParameters> params(parameters != nullptr ? new H5ZIOParameters(*parameters) : nullptr);
+    std::shared_ptr<H5ZioAttribute>  attrs(attributes != nullptr ? new H5ZioAttribute(*attributes) : nullptr);
+    return submit_io([this, dataset, buffer, shape, params, attrs]() mutable {
+        write_dataset<T>(dataset, buffer->data(), shape.size(), shape.data(), params.get(), attrs.get());
+    });
+}
+
 template <typename T>
 void H5Zio::read_dataset(std::string dataset, T* data)
 {
@@ -555,29 +1181,209 @@ void H5Zio::read_dataset(std::string dataset, T* data)
     {
         throw std::runtime_error("File is not open");
     }
-    hid_t dataspace_id, dataset_id;
-    dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    hid_t dataset_id = open_dataset(dataset);
+    read_dataset(dataset_id, h5_type<T>(), data);
+    H5Dclose(dataset_id);
+}
+
+template <typename T, typename Allocator> 
+H5Dimensions H5Zio::read_dataset(std::string dataset, std::vector<T, Allocator>& data)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = open_dataset(dataset);
+    H5Dimensions dims = dataset_dimensions(dataset_id);
+    data.resize(dims.total_size());
+    read_dataset(dataset_id, h5_type<T>(), data.data());
+    H5Dclose(dataset_id);
+    return dims;
+}
+
+template <typename T>
+H5ZioView<T> H5Zio::read_view(std::string dataset)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = open_dataset(dataset);
+    H5Dimensions dims = dataset_dimensions(dataset_id);
+    H5ZioView<T> view(buffers, dims.total_size());
+    view.get_dims().assign(dims.get_dims(), dims.get_dims() + dims.get_ndims());
+    read_dataset(dataset_id, h5_type<T>(), view.data());
+    H5Dclose(dataset_id);
+    return view;
+}
+
+template <typename T>
+H5ZioView<const T> H5Zio::map_view(std::string dataset)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = open_dataset(dataset);
+    H5Dimensions dims = dataset_dimensions(dataset_id);
+    void*  base   = nullptr;
+    size_t length = 0;
+    void*  data   = map_dataset(dataset_id, h5_type<T>(), dims.total_size() * sizeof(T), base, length);
+    if(data == nullptr)
+    {
+        // sem mapeamento: leitura em um buffer do pool, como em read_view
+        H5ZioView<const T> view(buffers, dims.total_size());
+        view.get_dims().assign(dims.get_dims(), dims.get_dims() + dims.get_ndims());
+        read_dataset(dataset_id, h5_type<T>(), const_cast<T*>(view.data()));
+        H5Dclose(dataset_id);
+        return view;
+    }
+    H5Dclose(dataset_id);
+    H5ZioView<const T> view(base, length, static_cast<const T*>(data), dims.total_size());
+    view.get_dims().assign(dims.get_dims(), dims.get_dims() + dims.get_ndims());
+    return view;
+}
+
+template <typename T>
+void H5Zio::read_region(std::string dataset, const hsize_t offset[], const hsize_t count[], const hsize_t stride[], T* data)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
     if(dataset_id < 0)
     {
         throw std::runtime_error("Failed to open dataset");
     }
-    H5Dread(dataset_id, h5_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    try
+    {
+        read_region(dataset_id, h5_type<T>(), offset, count, stride, data);
+    }
+    catch(...)
+    {
+        H5Dclose(dataset_id);
+        throw;
+    }
     H5Dclose(dataset_id);
+}
 
+template <typename T>
+void H5Zio::read_region(std::string dataset, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, T* data)
+{
+    if(offset.size() != count.size())
+    {
+        throw std::runtime_error("Region offset and count must have the same rank");
+    }
+    read_region<T>(dataset, offset.data(), count.data(), nullptr, data);
 }
 
 template <typename T>
-H5Dimensions H5Zio::read_dataset(std::string dataset, std::vector<T>& data)
+std::vector<T> H5Zio::read_region(std::string dataset, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, const std::vector<hsize_t>& stride)
+{
+    if(offset.size() != count.size() || (!stride.empty() && stride.size() != count.size()))
+    {
+        throw std::runtime_error("Region offset, count and stride must have the same rank");
+    }
+    hsize_t size = 1;
+    for(int i = 0; i < count.size(); i++)
+    {
+        size *= count[i];
+    }
+    std::vector<T> data(size);
+    read_region<T>(dataset, offset.data(), count.data(), stride.empty() ? nullptr : stride.data(), data.data());
+    return data;
+}
+
+template <typename T>
+void H5Zio::create_dataset(std::string dataset, hsize_t ndims, const hsize_t dims[], H5ZIOParameters* parameters, H5ZioAttribute* attributes)
 {
     if(!is_open)
     {
         throw std::runtime_error("File is not open");
     }
-    
-    H5Dimensions dims = dataset_dimensions(dataset);
-    data.resize(dims.total_size());
-    read_dataset(dataset, data.data());
-    return dims;
+    hid_t dataset_id = open_new_dataset(dataset, h5_type<T>(), type_size<T>(), ndims, dims, parameters);
+    write_attributes(dataset_id, attributes);
+    H5Dclose(dataset_id);
+}
+
+template <typename T>
+void H5Zio::write_region(std::string dataset, const hsize_t offset[], const hsize_t count[], const T* data)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    if(dataset_id < 0)
+    {
+        throw std::runtime_error("Failed to open dataset");
+    }
+    try
+    {
+        write_region(dataset_id, h5_type<T>(), type_size<T>(), offset, count, data);
+    }
+    catch(...)
+    {
+        H5Dclose(dataset_id);
+        throw;
+    }
+    H5Dclose(dataset_id);
+}
+
+template <typename T>
+void H5Zio::copy_dataset(H5Zio& input, std::string dataset, H5ZIOParameters* parameters, hsize_t memory_budget)
+{
+    if(!is_open || !input.is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    H5ZioDatasetStats record;
+    H5ZioTimer        wall;
+    H5Dimensions dims = input.dataset_dimensions(dataset);
+    create_dataset<T>(dataset, dims.get_ndims(), dims.get_dims(), parameters);
+    record.calls         = 1;
+    record.setup_seconds = wall.lap();
+    copy_blocks(input, dataset, h5_type<T>(), type_size<T>(), memory_budget, 
+                parameters != nullptr && parameters->get_verify() ? parameters : nullptr, record);
+    record.wall_seconds = record.setup_seconds + wall.lap();
+    add_stats(dataset, "write", record);
+}
+
+template <typename T>
+void H5Zio::create_timeseries(std::string dataset, hsize_t ndims, const hsize_t dims[], H5ZIOParameters* parameters, H5ZioAttribute* attributes)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    create_extendible(dataset, h5_type<T>(), type_size<T>(), ndims, dims, parameters, attributes);
+}
+
+template <typename T>
+void H5Zio::create_timeseries(std::string dataset, H5Dimensions& dims, H5ZIOParameters* parameters, H5ZioAttribute* attributes)
+{
+    create_timeseries<T>(dataset, dims.get_ndims(), dims.get_dims(), parameters, attributes);
+}
+
+template <typename T>
+void H5Zio::append(std::string dataset, const T* data)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    append_step(dataset, h5_type<T>(), type_size<T>(), data);
+}
+
+template <typename T>
+void H5Zio::append(std::string dataset, const std::vector<T>& data)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    append_step(dataset, h5_type<T>(), type_size<T>(), data.data(), data.size());
 }
 
 #endif     /* H5ZIO_H__ */
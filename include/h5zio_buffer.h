@@ -0,0 +1,212 @@
+#ifndef H5ZIO_BUFFER_H__
+#define H5ZIO_BUFFER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+#include "hdf5.h"
+
+namespace H5ZIO {
+
+    // alinhamento dos buffers de leitura (linha de cache / AVX-512)
+    const size_t BUFFER_ALIGNMENT = 64;
+
+    /**
+     * @brief Aloca memória alinhada em BUFFER_ALIGNMENT bytes, sem inicializá-la
+     *
+     * @param bytes : tamanho em bytes
+     * @return ponteiro para a memória (lança std::bad_alloc em caso de falha)
+     */
+    void* aligned_malloc(size_t bytes);
+    void  aligned_free(void* ptr);
+
+    /**
+     * @brief Mapeia, somente para leitura, um trecho de um arquivo em memória
+     *
+     * @param file_name : nome do arquivo
+     * @param offset    : posição do trecho no arquivo em bytes
+     * @param bytes     : tamanho do trecho
+     * @param base      : [saída] início do mapeamento, usado em unmap
+     * @param length    : [saída] tamanho do mapeamento
+     * @return ponteiro para o trecho ou nullptr se o mapeamento falhar
+     */
+    void* map_file(const std::string& file_name, size_t offset, size_t bytes, void*& base, size_t& length);
+    void  unmap_file(void* base, size_t length);
+
+    /**
+     * @brief Alocador alinhado que não inicializa os elementos em resize.
+     *        Com std::vector<T, H5ZIO::aligned_allocator<T> > a leitura de
+     *        um dataset não passa pela memória zerando o vetor antes do HDF5
+     *
+     */
+    template <typename T>
+    class aligned_allocator
+    {
+        public:
+            typedef T value_type;
+
+            aligned_allocator() {}
+            template <typename U> aligned_allocator(const aligned_allocator<U>&) {}
+            template <typename U> struct rebind {typedef aligned_allocator<U> other;};
+
+            T* allocate(size_t n) {return static_cast<T*>(aligned_malloc(n * sizeof(T)));}
+            void deallocate(T* p, size_t) {aligned_free(p);}
+
+            // default-initialization: tipos fundamentais ficam sem valor
+            template <typename U>
+            void construct(U* p) {::new(static_cast<void*>(p)) U;}
+            template <typename U, typename... Args>
+            void construct(U* p, Args&&... args) {::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);}
+    };
+
+    template <typename T, typename U>
+    bool operator==(const aligned_allocator<T>&, const aligned_allocator<U>&) {return true;}
+    template <typename T, typename U>
+    bool operator!=(const aligned_allocator<T>&, const aligned_allocator<U>&) {return false;}
+
+}
+
+/**
+ * @brief Pool de buffers alinhados reutilizados entre leituras.
+ *        Um buffer liberado volta ao pool e é entregue à próxima
+ *        requisição que caiba nele sem desperdiçar mais da metade
+ *
+ */
+class H5ZioBufferPool
+{
+    public:
+        H5ZioBufferPool() : cached_bytes(0) {}
+        ~H5ZioBufferPool() {clear();}
+
+        H5ZioBufferPool(const H5ZioBufferPool&) = delete;
+        H5ZioBufferPool& operator=(const H5ZioBufferPool&) = delete;
+
+        /**
+         * @brief Obtém um buffer com pelo menos bytes bytes
+         *
+         * @param bytes    : tamanho requisitado
+         * @param capacity : [saída] tamanho real do buffer, usado em release
+         */
+        void* acquire(size_t bytes, size_t& capacity);
+
+        // devolve um buffer ao pool
+        void release(void* buffer, size_t capacity);
+
+        // libera a memória dos buffers que não estão em uso
+        void clear();
+
+        // total de bytes mantidos no pool
+        size_t get_cached_bytes() {return cached_bytes;}
+
+    private:
+        std::multimap<size_t, void*> free_buffers;
+        size_t                       cached_bytes;
+        std::mutex                   mutex;
+};
+
+/**
+ * @brief Dados de um dataset lidos em um buffer do pool ou mapeados
+ *        diretamente do arquivo. O buffer volta ao pool, ou o 
+ *        mapeamento é desfeito, quando a view é destruída. Views 
+ *        mapeadas são do tipo H5ZioView<const T>, sem acesso de escrita
+ *
+ */
+template <typename T>
+class H5ZioView
+{
+    public:
+        H5ZioView() : buffer(nullptr), capacity(0), nelements(0), map_base(nullptr), map_length(0) {}
+        H5ZioView(std::shared_ptr<H5ZioBufferPool> pool, size_t nelements)
+            : pool(pool), nelements(nelements), map_base(nullptr), map_length(0)
+        {
+            buffer = static_cast<T*>(pool->acquire(nelements * sizeof(T), capacity));
+        }
+        H5ZioView(void* map_base, size_t map_length, T* data, size_t nelements)
+            : buffer(data), capacity(0), nelements(nelements), map_base(map_base), map_length(map_length) {}
+        ~H5ZioView() {reset();}
+
+        H5ZioView(const H5ZioView&) = delete;
+        H5ZioView& operator=(const H5ZioView&) = delete;
+
+        H5ZioView(H5ZioView&& other)
+            : pool(std::move(other.pool)), buffer(other.buffer), capacity(other.capacity),
+              nelements(other.nelements), map_base(other.map_base), map_length(other.map_length), 
+              dims(std::move(other.dims))
+        {
+            other.buffer     = nullptr;
+            other.capacity   = 0;
+            other.nelements  = 0;
+            other.map_base   = nullptr;
+            other.map_length = 0;
+        }
+        H5ZioView& operator=(H5ZioView&& other)
+        {
+            if(this != &other)
+            {
+                reset();
+                pool      = std::move(other.pool);
+                buffer    = other.buffer;
+                capacity  = other.capacity;
+                nelements = other.nelements;
+                map_base  = other.map_base;
+                map_length = other.map_length;
+                dims      = std::move(other.dims);
+                other.buffer     = nullptr;
+                other.capacity   = 0;
+                other.nelements  = 0;
+                other.map_base   = nullptr;
+                other.map_length = 0;
+            }
+            return *this;
+        }
+
+        T*       data()        {return buffer;}
+        const T* data() const  {return buffer;}
+        size_t   size() const  {return nelements;}
+        bool     empty() const {return nelements == 0;}
+        // indica se os dados estão mapeados do arquivo (somente leitura)
+        bool     is_mapped() const {return map_base != nullptr;}
+        T*       begin()       {return buffer;}
+        T*       end()         {return buffer + nelements;}
+        T&       operator[](size_t i)       {return buffer[i];}
+        const T& operator[](size_t i) const {return buffer[i];}
+
+        // dimensões do dataset lido
+        std::vector<hsize_t>& get_dims() {return dims;}
+
+        // devolve o buffer ao pool ou desfaz o mapeamento
+        void reset()
+        {
+            if(map_base != nullptr)
+            {
+                H5ZIO::unmap_file(map_base, map_length);
+            }
+            else if(buffer != nullptr)
+            {
+                pool->release(const_cast<void*>(static_cast<const void*>(buffer)), capacity);
+            }
+            buffer     = nullptr;
+            capacity   = 0;
+            nelements  = 0;
+            map_base   = nullptr;
+            map_length = 0;
+            pool.reset();
+        }
+
+    private:
+        std::shared_ptr<H5ZioBufferPool> pool;
+        T*                               buffer;
+        size_t                           capacity;
+        size_t                           nelements;
+        void*                            map_base;
+        size_t                           map_length;
+        std::vector<hsize_t>             dims;
+};
+
+#endif     /* H5ZIO_BUFFER_H__ */
@@ -0,0 +1,141 @@
+#ifndef H5ZIO_CODEC_H__
+#define H5ZIO_CODEC_H__
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "hdf5.h"
+#include "h5zio_config.h"
+
+namespace H5ZIO {
+
+    /**
+     * @brief Copia um bloco retangular de um array n-dimensional para outro.
+     *        Os arrays são armazenados em ordem row-major (última dimensão contígua)
+     *
+     * @param ndims     : número de dimensões
+     * @param elem_size : tamanho de um elemento em bytes
+     * @param count     : dimensões do bloco copiado
+     * @param src       : array de origem
+     * @param src_dims  : dimensões do array de origem
+     * @param src_start : posição do bloco no array de origem
+     * @param dst       : array de destino
+     * @param dst_dims  : dimensões do array de destino
+     * @param dst_start : posição do bloco no array de destino
+     */
+    void copy_box(hsize_t ndims, size_t elem_size, const hsize_t count[],
+                  const void* src, const hsize_t src_dims[], const hsize_t src_start[],
+                  void* dst, const hsize_t dst_dims[], const hsize_t dst_start[]);
+
+}
+
+/**
+ * @brief Percorre os chunks de um dataset em ordem row-major.
+ *        Se uma região for informada, somente os chunks que a 
+ *        interceptam são percorridos
+ *
+ */
+class H5ZioChunkGrid
+{
+    public:
+        H5ZioChunkGrid(hsize_t ndims, const hsize_t dims[], const hsize_t chunk_dims[], 
+                       const hsize_t region_start[] = nullptr, const hsize_t region_count[] = nullptr);
+
+        hsize_t get_ndims()            {return ndims;}
+        const hsize_t* get_dims()      {return dims.data();}
+        const hsize_t* get_chunk_dims(){return chunk_dims.data();}
+
+        // número total de chunks
+        hsize_t size();
+
+        /**
+         * @brief Obtém a posição e o tamanho válido de um chunk.
+         *        Chunks da borda podem ser menores que chunk_dims
+         *
+         * @param index  : índice do chunk
+         * @param offset : [saída] posição do chunk no dataset
+         * @param count  : [saída] número de elementos válidos em cada dimensão
+         */
+        void chunk(hsize_t index, hsize_t offset[], hsize_t count[]);
+
+    private:
+        hsize_t              ndims;
+        std::vector<hsize_t> dims;
+        std::vector<hsize_t> chunk_dims;
+        std::vector<hsize_t> first_chunk;
+        std::vector<hsize_t> nchunks;
+};
+
+/**
+ * @brief Codifica e decodifica chunks fora do pipeline de filtros do HDF5,
+ *        chamando diretamente as bibliotecas ZFP, SZ e zlib e o codec intpack.
+ *        Os parâmetros são lidos do filtro gravado no dataset, de forma que os
+ *        chunks produzidos são idênticos aos dos filtros registrados em create_filter
+ *        (no ZFP, cabeçalho completo seguido do fluxo comprimido, como no H5Z-ZFP;
+ *        no SZ, o fluxo do SZ_compress_args ou do SZ_compress, como no H5Z-SZ).
+ *        Além de um único filtro, aceita o encadeamento shuffle + deflate.
+ *        encode e decode podem ser chamados concorrentemente; somente o
+ *        construtor acessa o HDF5.
+ *
+ */
+class H5ZioChunkCodec
+{
+    public:
+        /**
+         * @brief Lê o filtro, o tipo e o formato dos chunks de um dataset
+         *
+         * @param dataset_id : dataset aberto
+         */
+        H5ZioChunkCodec(hid_t dataset_id);
+        ~H5ZioChunkCodec();
+
+        /**
+         * @brief Indica se os chunks do dataset podem ser processados diretamente.
+         *        Datasets contíguos, com outros encadeamentos ou filtros desconhecidos
+         *        devem usar H5Dwrite/H5Dread
+         */
+        bool is_supported() {return supported;}
+
+        // filtro opcional: chunks que não diminuem podem ser gravados sem ele
+        bool is_optional()  {return (flags & H5Z_FLAG_OPTIONAL) != 0;}
+        // máscara de filtros de um chunk gravado sem nenhum filtro do encadeamento
+        uint32_t get_raw_mask() {return shuffle ? 0x3 : 0x1;}
+
+        hsize_t get_ndims()             {return chunk_dims.size();}
+        const hsize_t* get_chunk_dims() {return chunk_dims.data();}
+        size_t  get_element_size()      {return element_size;}
+        // tipo dos elementos no arquivo
+        hid_t   get_type()              {return type_id;}
+        // tamanho em bytes de um chunk completo
+        size_t  get_chunk_bytes();
+
+        /**
+         * @brief Codifica um chunk completo
+         *
+         * @param chunk : dados do chunk (get_chunk_bytes() bytes)
+         * @param out   : [saída] chunk codificado
+         */
+        void encode(const void* chunk, std::vector<unsigned char>& out);
+
+        /**
+         * @brief Decodifica um chunk completo
+         *
+         * @param in      : chunk codificado
+         * @param in_size : tamanho do chunk codificado
+         * @param chunk   : [saída] dados do chunk (get_chunk_bytes() bytes)
+         */
+        void decode(const void* in, size_t in_size, void* chunk);
+
+    private:
+        bool                      supported;
+        bool                      shuffle;      // shuffle antes de filter
+        H5Z_filter_t              filter;
+        unsigned int              flags;
+        std::vector<unsigned int> cd_values;
+        std::vector<hsize_t>      chunk_dims;
+        hid_t                     type_id;
+        size_t                    element_size;
+};
+
+#endif     /* H5ZIO_CODEC_H__ */
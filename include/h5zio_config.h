@@ -2,4 +2,6 @@
 #define H5ZIO_HAS_ZFP 1
 #define H5ZIO_HAS_SZ 1
 #define H5ZIO_HAS_GZIP 1
+#define H5ZIO_HAS_ZLIB 1
+#define H5ZIO_HAS_TRACE 1
 
@@ -0,0 +1,93 @@
+#ifndef H5ZIO_FILTER_TIMER_H__
+#define H5ZIO_FILTER_TIMER_H__
+
+#include "hdf5.h"
+#include "h5zio_stats.h"
+
+/**
+ * @brief Medição dos filtros executados por chunk (tempo, bytes de entrada e
+ *        saída e número de chunks), acumulada no registro associado à thread
+ *        por H5ZioFilterScope.
+ *
+ *        Os filtros registrados pelo h5zio (register_class) são medidos dentro
+ *        do pipeline do HDF5: install registra de novo a classe com H5Zregister,
+ *        com uma função que chama a original, e uninstall restaura a classe
+ *        original. Os arquivos gravados não mudam.
+ *
+ *        Os filtros predefinidos (deflate, shuffle) e os plugins (ZFP, SZ) não
+ *        podem ser substituídos pela API pública: são medidos somente quando
+ *        codificados fora do HDF5 por H5ZioChunkCodec (add_chunk, no caminho
+ *        de chunks diretos com mais de uma thread). No pipeline do HDF5, o
+ *        tempo deles fica em io_seconds (H5Dwrite/H5Dread).
+ *
+ *        A medição vale enquanto houver um usuário (enable); o último
+ *        disable restaura as classes originais.
+ *
+ *        O HDF5 executa os filtros na thread que chamou H5Dwrite/H5Dread
+ *        (ou H5Dclose, ao esvaziar o cache de chunks), por isso o registro
+ *        corrente é mantido por thread.
+ *
+ */
+class H5ZioFilterTimer
+{
+    public:
+        static const int MAX_FILTERS = 8;
+
+        /**
+         * @brief Publica a classe de um filtro registrado pelo h5zio, que
+         *        passa a poder ser medido. Chamadas repetidas para o mesmo
+         *        filtro não têm efeito
+         *
+         * @return false se já houver MAX_FILTERS classes
+         */
+        static bool register_class(const H5Z_class2_t& filter_class);
+
+        // contagem de usuários da medição: o último disable chama uninstall
+        static void enable();
+        static void disable();
+
+        /**
+         * @brief Passa a medir um filtro publicado com register_class.
+         *        Chamadas repetidas para o mesmo filtro não têm efeito
+         *
+         * @param filter : identificador do filtro
+         * @return false sem enable, para filtros que não são do h5zio
+         *         (predefinidos e plugins) ou se H5Zregister falhar
+         */
+        static bool install(H5Z_filter_t filter);
+
+        // mede os filtros do h5zio usados por um dataset
+        static void install(hid_t dataset_id);
+
+        // restaura as classes originais de todos os filtros medidos
+        static void uninstall();
+
+        static bool is_installed(H5Z_filter_t filter);
+
+        // registro que recebe as medições da thread corrente (nullptr: nenhum)
+        static H5ZioDatasetStats* attach(H5ZioDatasetStats* record);
+        static H5ZioDatasetStats* current();
+
+        // acumula a execução de um filtro (ou de um encadeamento codificado por H5ZioChunkCodec) em um chunk
+        static void add_chunk(H5ZioDatasetStats* record, size_t input_bytes, size_t output_bytes, double seconds);
+};
+
+/**
+ * @brief Associa um registro às execuções de filtros da thread corrente
+ *        durante o escopo, restaurando o anterior ao final
+ *
+ */
+class H5ZioFilterScope
+{
+    public:
+        explicit H5ZioFilterScope(H5ZioDatasetStats* record) : previous(H5ZioFilterTimer::attach(record)) {}
+        ~H5ZioFilterScope() {H5ZioFilterTimer::attach(previous);}
+
+        H5ZioFilterScope(const H5ZioFilterScope&) = delete;
+        H5ZioFilterScope& operator=(const H5ZioFilterScope&) = delete;
+
+    private:
+        H5ZioDatasetStats* previous;
+};
+
+#endif     /* H5ZIO_FILTER_TIMER_H__ */
@@ -0,0 +1,72 @@
+#ifndef H5ZIO_INTPACK_H__
+#define H5ZIO_INTPACK_H__
+
+#include <vector>
+#include <cstddef>
+
+#include "hdf5.h"
+
+/**
+ * Compressão sem perdas de inteiros (conectividade e índices de malhas).
+ * Os valores são processados em blocos de INTPACK_BLOCK elementos; em cada
+ * bloco é escolhida a representação de menor largura em bits entre
+ *   - referência (frame of reference): valor - mínimo do bloco;
+ *   - delta: diferença para o valor anterior, mapeada em zig-zag
+ *     ((d << 1) ^ (d >> 63)) e subtraída do mínimo do bloco.
+ * Os resíduos são empacotados com a mesma largura em INTPACK_LANES faixas
+ * intercaladas de palavras de 64 bits: o deslocamento de um valor é o mesmo
+ * em todas as faixas, e o laço das faixas, sem desvios, é vetorizado
+ * (omp simd) com deslocamentos de 64 bits empacotados. Sequências monótonas
+ * de passo constante usam 0 bits por valor.
+ *
+ * Formato de um chunk (ordem de bytes do processo, registrada no cabeçalho):
+ *   cabeçalho de 16 bytes: versão, tamanho do elemento, sinal, ordem de bytes,
+ *                          4 bytes reservados, número de elementos (64 bits)
+ *   por bloco: modo (1 byte), largura (1 byte), referência (8 bytes) e
+ *              largura * INTPACK_LANES palavras de 64 bits
+ */
+namespace H5ZIO {
+
+    // filtro do h5zio no intervalo de uso privado do HDF5 (32768-65535), fora do
+    // intervalo de testes (256-511) e dos identificadores registrados no HDF Group
+    const H5Z_filter_t FILTER_INTPACK  = 32768;
+    const size_t       INTPACK_LANES   = 8;
+    const size_t       INTPACK_BLOCK   = 64 * INTPACK_LANES;
+    const size_t       INTPACK_HEADER  = 16;
+
+    /**
+     * @brief Registra o filtro no HDF5. Chamado pelo construtor de H5Zio;
+     *        chamadas repetidas não têm efeito
+     *
+     * @return false se o registro falhar
+     */
+    bool register_intpack();
+
+    /**
+     * @brief Codifica um array de inteiros
+     *
+     * @param data         : valores
+     * @param count        : número de valores
+     * @param element_size : tamanho de cada valor em bytes (1, 2, 4 ou 8)
+     * @param is_signed    : inteiros com sinal
+     * @param out          : [saída] dados codificados
+     */
+    void intpack_encode(const void* data, size_t count, size_t element_size, bool is_signed, std::vector<unsigned char>& out);
+
+    /**
+     * @brief Decodifica um array de inteiros
+     *
+     * @param in       : dados codificados
+     * @param in_size  : tamanho dos dados codificados
+     * @param data     : [saída] valores
+     * @param capacity : tamanho de data em bytes
+     * @return número de bytes decodificados
+     */
+    size_t intpack_decode(const void* in, size_t in_size, void* data, size_t capacity);
+
+    // tamanho em bytes dos valores de um chunk codificado, lido do cabeçalho
+    size_t intpack_decoded_size(const void* in, size_t in_size);
+
+}
+
+#endif     /* H5ZIO_INTPACK_H__ */
@@ -0,0 +1,187 @@
+#ifndef H5ZIO_METRICS_H__
+#define H5ZIO_METRICS_H__
+
+#include <vector>
+#include <future>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include "h5zio_thread_pool.h"
+
+/**
+ * @brief Métricas de erro entre um array original e sua reconstrução:
+ *        erro absoluto e relativo máximos, RMSE, NRMSE, PSNR, amplitude
+ *        dos dados e correlação de Pearson. Os dados são percorridos uma
+ *        única vez, em blocos que cabem na cache; cada bloco é reduzido por
+ *        um laço "omp simd" (vetorizado com -fopenmp-simd e -fno-trapping-math,
+ *        ligados no CMakeLists.txt) e os momentos dos blocos são combinados
+ *        com as fórmulas de Chan et al. Chamadas
+ *        sucessivas de update acumulam chunks de um mesmo array e merge
+ *        combina métricas calculadas em paralelo
+ *
+ */
+class H5ZioMetrics
+{
+    public:
+        H5ZioMetrics();
+
+        // elementos por bloco
+        static const size_t BLOCK_SIZE = 4096;
+
+        /**
+         * @brief Acumula as métricas de um trecho dos arrays
+         *
+         * @tparam T       : tipo dos dados
+         * @param original : dados originais
+         * @param decoded  : dados reconstruídos
+         * @param n        : número de elementos
+         */
+        template <typename T>
+        void update(const T* original, const T* decoded, size_t n);
+
+        // combina as métricas de outro trecho do mesmo array
+        void merge(const H5ZioMetrics& other);
+        void reset();
+
+        size_t get_count()          const {return count;}
+        double get_max_abs_error()  const {return max_abs_error;}
+        // erro relativo máximo, |x - y| / |x|, ignorando os valores originais nulos
+        double get_max_rel_error()  const {return max_rel_error;}
+        double get_min()            const {return minimum;}
+        double get_max()            const {return maximum;}
+        double get_range()          const {return count > 0 ? maximum - minimum : 0.0;}
+        double get_mse()            const {return count > 0 ? sum_squared_error / count : 0.0;}
+        double get_rmse()           const {return std::sqrt(get_mse());}
+        // RMSE normalizado pela amplitude dos dados originais
+        double get_nrmse()          const;
+        // PSNR em dB, calculado com a amplitude dos dados originais
+        double get_psnr()           const;
+        double get_pearson()        const;
+
+    private:
+
+        // combina os momentos de count elementos
+        void add(size_t count, double minimum, double maximum, double max_abs_error, double max_rel_error,
+                 double sum_squared_error, double mean_x, double mean_y, double m2x, double m2y, double cxy);
+
+        size_t count;
+        double minimum;
+        double maximum;
+        double max_abs_error;
+        double max_rel_error;
+        double sum_squared_error;
+        // médias e momentos centrados de segunda ordem (original x, reconstruído y)
+        double mean_x;
+        double mean_y;
+        double m2x;
+        double m2y;
+        double cxy;
+};
+
+namespace H5ZIO {
+
+    // arrays menores que isso são processados por uma única thread
+    const size_t METRICS_PARALLEL_THRESHOLD = 1 << 20;
+
+    /**
+     * @brief Calcula as métricas de erro de um array, dividindo-o entre
+     *        num_threads threads quando ele é grande
+     *
+     * @param num_threads : número de threads (0 usa todos os núcleos)
+     */
+    template <typename T>
+    H5ZioMetrics compute_metrics(const T* original, const T* decoded, size_t n, unsigned int num_threads = 0)
+    {
+        H5ZioMetrics metrics;
+        if(num_threads == 0)
+        {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if(num_threads == 1 || n < METRICS_PARALLEL_THRESHOLD)
+        {
+            metrics.update(original, decoded, n);
+            return metrics;
+        }
+
+        // trechos múltiplos do bloco, para que cada thread reduza blocos inteiros
+        size_t blocks = (n + H5ZioMetrics::BLOCK_SIZE - 1) / H5ZioMetrics::BLOCK_SIZE;
+        size_t step   = (blocks + num_threads - 1) / num_threads * H5ZioMetrics::BLOCK_SIZE;
+
+        H5ZioThreadPool pool(num_threads);
+        std::vector<std::future<H5ZioMetrics> > partial;
+        for(size_t start = 0; start < n; start += step)
+        {
+            size_t length = std::min(step, n - start);
+            partial.push_back(pool.submit([original, decoded, start, length]() {
+                H5ZioMetrics local;
+                local.update(original + start, decoded + start, length);
+                return local;
+            }));
+        }
+        for(auto& result : partial)
+        {
+            metrics.merge(result.get());
+        }
+        return metrics;
+    }
+
+    template <typename T, typename A>
+    H5ZioMetrics compute_metrics(const std::vector<T, A>& original, const std::vector<T, A>& decoded, unsigned int num_threads = 0)
+    {
+        return compute_metrics(original.data(), decoded.data(), std::min(original.size(), decoded.size()), num_threads);
+    }
+
+}
+
+template <typename T>
+void H5ZioMetrics::update(const T* original, const T* decoded, size_t n)
+{
+    for(size_t start = 0; start < n; start += BLOCK_SIZE)
+    {
+        const T* x = original + start;
+        const T* y = decoded  + start;
+        size_t   m = std::min(BLOCK_SIZE, n - start);
+
+        // somas deslocadas pelo primeiro par do bloco: os momentos centrados saem
+        // da mesma passada sem o cancelamento das somas de quadrados brutas
+        double shift_x = static_cast<double>(x[0]);
+        double shift_y = static_cast<double>(y[0]);
+        double block_min = shift_x, block_max = shift_x, block_abs = 0.0, block_rel = 0.0;
+        double sse = 0.0, sum_dx = 0.0, sum_dy = 0.0, sum_xx = 0.0, sum_yy = 0.0, sum_xy = 0.0;
+#pragma omp simd reduction(min:block_min) reduction(max:block_max, block_abs, block_rel) \
+                 reduction(+:sse, sum_dx, sum_dy, sum_xx, sum_yy, sum_xy)
+        for(size_t i = 0; i < m; i++)
+        {
+            double a     = static_cast<double>(x[i]);
+            double b     = static_cast<double>(y[i]);
+            double error = std::fabs(a - b);
+            // divisão sem desvio; o resultado dos valores nulos é descartado na seleção
+            double scale = std::fabs(a);
+            double rel   = error / scale;
+            rel          = scale > 0.0 ? rel : 0.0;
+            double dx    = a - shift_x;
+            double dy    = b - shift_y;
+            block_min    = a < block_min ? a : block_min;
+            block_max    = a > block_max ? a : block_max;
+            block_abs    = error > block_abs ? error : block_abs;
+            block_rel    = rel > block_rel ? rel : block_rel;
+            sse         += error * error;
+            sum_dx      += dx;
+            sum_dy      += dy;
+            sum_xx      += dx * dx;
+            sum_yy      += dy * dy;
+            sum_xy      += dx * dy;
+        }
+
+        double block_mean_x = shift_x + sum_dx / m;
+        double block_mean_y = shift_y + sum_dy / m;
+        double block_m2x    = std::max(sum_xx - sum_dx * sum_dx / m, 0.0);
+        double block_m2y    = std::max(sum_yy - sum_dy * sum_dy / m, 0.0);
+        double block_cxy    = sum_xy - sum_dx * sum_dy / m;
+
+        add(m, block_min, block_max, block_abs, block_rel, sse, block_mean_x, block_mean_y, block_m2x, block_m2y, block_cxy);
+    }
+}
+
+#endif     /* H5ZIO_METRICS_H__ */
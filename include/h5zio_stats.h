@@ -0,0 +1,145 @@
+#ifndef H5ZIO_STATS_H__
+#define H5ZIO_STATS_H__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <cstddef>
+
+#include "hdf5.h"
+
+/**
+ * @brief Estatísticas de uma operação (escrita ou leitura) em um dataset.
+ *        Operações repetidas no mesmo dataset (append, write_region) são
+ *        acumuladas no mesmo registro
+ *
+ */
+struct H5ZioDatasetStats
+{
+    H5ZioDatasetStats() : calls(0), raw_bytes(0), stored_bytes(0), wall_seconds(0.0), setup_seconds(0.0), io_seconds(0.0),
+                          compression_seconds(0.0), metadata_seconds(0.0), peak_buffer_bytes(0), filter_chunks(0),
+                          filter_input_bytes(0), filter_output_bytes(0), filter_seconds(0.0), max_chunk_seconds(0.0) {}
+
+    std::string dataset;
+    std::string operation;           // "write" ou "read"
+    hsize_t     calls;
+    hsize_t     raw_bytes;           // dados sem compressão
+    hsize_t     stored_bytes;        // dados armazenados no arquivo
+    double      wall_seconds;        // tempo total da operação
+    double      setup_seconds;       // criação dos filtros e abertura/criação do dataset
+    double      io_seconds;          // H5Dwrite/H5Dread e H5Dwrite_chunk/H5Dread_chunk; nos dois primeiros inclui os filtros do HDF5
+    double      compression_seconds; // codificação/decodificação no pool, somada entre as threads
+    double      metadata_seconds;    // atributos, tamanho armazenado e fechamento do dataset
+    size_t      peak_buffer_bytes;   // pico de memória em buffers de chunks e blocos alocados pelo H5Zio
+
+    // filtros medidos com H5Zio::set_filter_timing: os do h5zio no pipeline do HDF5 e, no 
+    // caminho de chunks diretos, o encadeamento codificado por H5ZioChunkCodec
+    hsize_t     filter_chunks;       // execuções (uma por chunk e filtro do h5zio, ou por chunk direto)
+    hsize_t     filter_input_bytes;
+    hsize_t     filter_output_bytes;
+    double      filter_seconds;      // contido em io_seconds (pipeline do HDF5; em metadata_seconds, se o cache de chunks
+                                     // for esvaziado no fechamento) ou em compression_seconds (chunks diretos)
+    double      max_chunk_seconds;   // execução mais lenta
+
+    double get_ratio() const {return stored_bytes > 0 ? static_cast<double>(raw_bytes) / stored_bytes : 0.0;}
+
+    // acumula outra operação no mesmo dataset
+    void merge(const H5ZioDatasetStats& other);
+};
+
+/**
+ * @brief Cronômetro de parede: lap retorna os segundos desde a última chamada
+ *
+ */
+class H5ZioTimer
+{
+    public:
+        H5ZioTimer() : last(std::chrono::steady_clock::now()) {}
+        double lap()
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(now - last).count();
+            last = now;
+            return seconds;
+        }
+    private:
+        std::chrono::steady_clock::time_point last;
+};
+
+/**
+ * @brief Contador de memória em uso e de seu pico, atualizado
+ *        concorrentemente pelas tarefas do pool de threads
+ *
+ */
+class H5ZioMemoryTracker
+{
+    public:
+        H5ZioMemoryTracker() : current(0), peak(0) {}
+        void acquire(size_t bytes)
+        {
+            size_t now  = current.fetch_add(bytes) + bytes;
+            size_t seen = peak.load();
+            while(now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        }
+        void release(size_t bytes) {current.fetch_sub(bytes);}
+        size_t get_peak() const {return peak.load();}
+    private:
+        std::atomic<size_t> current;
+        std::atomic<size_t> peak;
+};
+
+/**
+ * @brief Estatísticas de I/O por dataset de uma instância de H5Zio. Pode
+ *        ser consultado a qualquer momento, inclusive durante escritas
+ *        assíncronas, e exportado em JSON ou CSV
+ *
+ */
+class H5ZioStats
+{
+    public:
+        H5ZioStats() {}
+
+        // registra uma operação, acumulando-a se o dataset já tiver um registro da mesma operação
+        void add(const H5ZioDatasetStats& stats);
+
+        // cópia dos registros, na ordem da primeira operação em cada dataset
+        std::vector<H5ZioDatasetStats> get_datasets();
+
+        // registro de um dataset (vazio se não houver)
+        H5ZioDatasetStats get_dataset(const std::string& dataset, const std::string& operation = "write");
+
+        // soma de todos os registros de uma operação
+        H5ZioDatasetStats get_total(const std::string& operation = "write");
+
+        size_t size();
+        void   clear();
+
+        void write_json(std::ostream& out);
+        void write_csv(std::ostream& out);
+
+        /**
+         * @brief Grava as estatísticas em um arquivo: JSON se o nome
+         *        terminar em .json, CSV nos demais casos
+         *
+         * @param filename
+         */
+        void save(const std::string& filename);
+
+    private:
+        std::vector<H5ZioDatasetStats>                        records;
+        std::map<std::pair<std::string, std::string>, size_t> index;
+        std::mutex                                            mutex;
+};
+
+namespace H5ZIO {
+
+    // número em JSON com 10 algarismos significativos: valores não finitos, que não existem em JSON, são gravados como null
+    std::string json_number(double value);
+
+}
+
+#endif     /* H5ZIO_STATS_H__ */
@@ -0,0 +1,103 @@
+#ifndef H5ZIO_THREAD_POOL_H__
+#define H5ZIO_THREAD_POOL_H__
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @brief Pool de threads simples usado para comprimir e descomprimir chunks.
+ *        As tarefas não devem chamar rotinas do HDF5, que fica restrito à
+ *        thread que controla o arquivo.
+ *
+ */
+class H5ZioThreadPool
+{
+    public:
+        H5ZioThreadPool(unsigned int nthreads = std::thread::hardware_concurrency())
+        {
+            if(nthreads == 0) nthreads = 1;
+            stop = false;
+            for(unsigned int i = 0; i < nthreads; i++)
+            {
+                workers.emplace_back([this] { run(); });
+            }
+        }
+
+        ~H5ZioThreadPool()
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                stop = true;
+            }
+            condition.notify_all();
+            for(auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        H5ZioThreadPool(const H5ZioThreadPool&) = delete;
+        H5ZioThreadPool& operator=(const H5ZioThreadPool&) = delete;
+
+        unsigned int size() {return workers.size();}
+
+        /**
+         * @brief Submete uma tarefa ao pool
+         *
+         * @param task  : função a ser executada
+         * @return std::future com o resultado da tarefa
+         */
+        template <typename F>
+        auto submit(F&& task) -> std::future<decltype(task())>
+        {
+            typedef decltype(task()) result_type;
+            auto packaged = std::make_shared<std::packaged_task<result_type()> >(std::forward<F>(task));
+            std::future<result_type> result = packaged->get_future();
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if(stop)
+                {
+                    throw std::runtime_error("Thread pool is stopped");
+                }
+                tasks.emplace([packaged] { (*packaged)(); });
+            }
+            condition.notify_one();
+            return result;
+        }
+
+    private:
+
+        void run()
+        {
+            while(true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [this] { return stop || !tasks.empty(); });
+                    if(stop && tasks.empty())
+                    {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread>          workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex                        mutex;
+        std::condition_variable           condition;
+        bool                              stop;
+};
+
+#endif     /* H5ZIO_THREAD_POOL_H__ */
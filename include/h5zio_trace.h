@@ -0,0 +1,100 @@
+#ifndef H5ZIO_TRACE_H__
+#define H5ZIO_TRACE_H__
+
+#include <string>
+#include <ostream>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "h5zio_config.h"
+
+/**
+ * @brief Linha do tempo das operações internas de escrita e leitura,
+ *        exportada no formato de trace do Chrome/Perfetto (chrome://tracing,
+ *        ui.perfetto.dev). Cada probe grava um evento com início, fim e
+ *        thread em um buffer circular sem locks; quando o buffer enche, os
+ *        eventos mais antigos são sobrescritos.
+ *
+ *        Desligado por padrão: um probe custa uma leitura atômica. Com a
+ *        opção H5ZIO_TRACE=OFF do CMake os probes não geram código.
+ *
+ */
+class H5ZioTrace
+{
+    public:
+        static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+        /**
+         * @brief Liga o rastreamento, descartando os eventos anteriores. Não
+         *        deve ser chamado durante operações de I/O em andamento
+         *
+         * @param capacity : número de eventos mantidos (arredondado para potência de 2)
+         */
+        static void enable(size_t capacity = DEFAULT_CAPACITY);
+        static void disable();
+        static bool is_enabled() {return enabled.load(std::memory_order_relaxed);}
+
+        // nanossegundos desde enable
+        static int64_t now();
+
+        // name deve ter duração estática (literal)
+        static void record(const char* name, int64_t begin, int64_t end);
+
+        // eventos gravados desde enable, incluindo os sobrescritos
+        static size_t recorded();
+
+        static void write_json(std::ostream& out);
+        static void save(const std::string& filename);
+
+    private:
+        struct event
+        {
+            std::atomic<uint64_t> sequence;   // posição + 1 quando completo; 0 durante a escrita
+            const char*           name;
+            uint32_t              thread;
+            int64_t               begin;
+            int64_t               end;
+        };
+
+        static std::atomic<bool>        enabled;
+        static std::atomic<uint64_t>    head;
+        static std::unique_ptr<event[]> events;
+        static size_t                   capacity;
+};
+
+/**
+ * @brief Probe de escopo: registra o intervalo entre construção e destruição
+ *
+ */
+class H5ZioTraceScope
+{
+    public:
+        explicit H5ZioTraceScope(const char* name) : name(H5ZioTrace::is_enabled() ? name : nullptr)
+        {
+            if(this->name) begin = H5ZioTrace::now();
+        }
+        ~H5ZioTraceScope()
+        {
+            if(name) H5ZioTrace::record(name, begin, H5ZioTrace::now());
+        }
+
+        H5ZioTraceScope(const H5ZioTraceScope&) = delete;
+        H5ZioTraceScope& operator=(const H5ZioTraceScope&) = delete;
+
+    private:
+        const char* name;
+        int64_t     begin;
+};
+
+#define H5ZIO_TRACE_CONCAT_(a, b) a##b
+#define H5ZIO_TRACE_CONCAT(a, b)  H5ZIO_TRACE_CONCAT_(a, b)
+
+#ifdef H5ZIO_HAS_TRACE
+#define H5ZIO_TRACE(name) H5ZioTraceScope H5ZIO_TRACE_CONCAT(h5zio_trace_, __LINE__)(name)
+#else
+#define H5ZIO_TRACE(name) ((void) 0)
+#endif
+
+#endif     /* H5ZIO_TRACE_H__ */
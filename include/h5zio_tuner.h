@@ -0,0 +1,432 @@
+#ifndef H5ZIO_TUNER_H__
+#define H5ZIO_TUNER_H__
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+#include <chrono>
+
+#include "h5zio.h"
+#include "h5zio_codec.h"
+
+namespace H5ZIO {
+
+    /**
+     * @brief enum class que define a métrica alvo do ajuste do limite de erro
+     *
+     */
+    enum class Target:int {
+        RATIO = 0,   // taxa de compressão (bytes originais / bytes armazenados)
+        PSNR  = 1    // PSNR em dB, calculado com a amplitude dos dados
+    };
+
+}
+
+/**
+ * @brief Ajusta o limite de erro de ZFP (accuracy) ou SZ2 (absoluto, relativo,
+ *        pointwise relativo ou PSNR) para atingir uma taxa de compressão ou um
+ *        PSNR, e escolhe o compressor de datasets com H5ZIO::Type::AUTO. 
+ *        Alguns blocos espalhados pelo array são comprimidos em um arquivo
+ *        em memória, com os filtros do HDF5, e o limite é procurado por bisseção
+ *        (em escala logarítmica para limites absolutos e relativos)
+ *
+ */
+class H5ZioTuner
+{
+    public:
+        H5ZioTuner();
+
+        // tolerância relativa em torno do valor alvo (default 5%)
+        void set_tolerance(double tolerance);
+        // número máximo de compressões da amostra (default 8)
+        void set_max_iterations(int iterations);
+        // fração do array usada como amostra (default 2%) e limite da amostra em bytes (default 4 MB)
+        void set_sample_fraction(double fraction);
+        void set_max_sample_size(hsize_t bytes);
+
+        /**
+         * @brief Procura o limite de erro que atinge o valor alvo. O custo é de no 
+         *        máximo max_iterations compressões da amostra; a amostra só é 
+         *        descomprimida quando o alvo é o PSNR. Dados constantes não têm
+         *        busca: o menor limite do intervalo é usado, com uma única medida
+         *
+         * @tparam T         : tipo dos dados (float ou double)
+         * @param data       : array de entrada
+         * @param ndims      : número de dimensões
+         * @param dims       : dimensões
+         * @param parameters : compressor, tipo de erro e chunks
+         * @param target     : métrica alvo
+         * @param value      : valor alvo (taxa de compressão ou PSNR em dB)
+         * @return H5ZIOParameters : parâmetros com o limite de erro encontrado
+         */
+        template <typename T>
+        H5ZIOParameters tune(const T* data, hsize_t ndims, const hsize_t dims[], H5ZIOParameters parameters,
+                             H5ZIO::Target target, double value);
+
+        /**
+         * @brief Escolhe o compressor (ZFP, SZ2 ou GZIP, entre os disponíveis) com a 
+         *        maior taxa de compressão na amostra entre os que comprimem a pelo menos 
+         *        parameters.get_min_throughput() MB/s (1 MB = 10^6 bytes). Se nenhum 
+         *        atingir a vazão mínima, o mais rápido é escolhido.
+         *        Os compressores são comparados com a mesma qualidade: os com perdas
+         *        usam o mesmo limite de erro absoluto (o limite de parameters, convertido
+         *        com a amplitude da amostra se for relativo), conferido na amostra 
+         *        decodificada, e o GZIP só perde se a taxa de um deles for maior que a
+         *        sua por mais que a tolerância. A vazão mede somente a codificação dos
+         *        chunks da amostra
+         *
+         * @tparam T         : tipo dos dados
+         * @param data       : array de entrada
+         * @param ndims      : número de dimensões
+         * @param dims       : dimensões
+         * @param parameters : limites de erro, chunks e vazão mínima
+         * @return H5ZIOParameters : parâmetros do compressor escolhido
+         */
+        template <typename T>
+        H5ZIOParameters select_codec(const T* data, hsize_t ndims, const hsize_t dims[], H5ZIOParameters parameters);
+
+        // o mesmo, lendo somente os blocos da amostra de um dataset
+        template <typename T>
+        H5ZIOParameters select_codec(H5Zio& input, std::string dataset, H5ZIOParameters parameters);
+
+        // resultado da amostra com o limite ou o compressor escolhido
+        double get_bound()      {return bound;}
+        double get_ratio()      {return ratio;}
+        // PSNR da amostra (somente tune com H5ZIO::Target::PSNR)
+        double get_psnr()       {return psnr;}
+        int    get_iterations() {return iterations;}
+        // vazão de compressão em MB/s (somente select_codec)
+        double get_throughput() {return throughput;}
+
+    private:
+
+        /**
+         * @brief Escolhe o formato e as posições dos blocos da amostra.
+         *        Os blocos são empilhados na primeira dimensão
+         */
+        void plan_sample(H5ZIOParameters& parameters, hsize_t ndims, const hsize_t dims[], size_t type_size,
+                         std::vector<hsize_t>& block, std::vector<std::vector<hsize_t> >& offsets);
+
+        /**
+         * @brief Copia os blocos da amostra, empilhados na primeira dimensão.
+         *        read_block(offset, count, destino) lê um bloco do array
+         */
+        template <typename T, typename Reader>
+        void gather_sample(Reader read_block, hsize_t ndims, const hsize_t dims[], H5ZIOParameters& parameters,
+                           std::vector<T>& sample, std::vector<hsize_t>& block, std::vector<hsize_t>& sample_dims);
+
+        /**
+         * @brief Compressores disponíveis. Os com perdas recebem o limite de erro 
+         *        absoluto equivalente ao de parameters (0 se parameters exigir 
+         *        compressão sem perdas)
+         */
+        std::vector<H5ZIOParameters> codec_candidates(H5ZIOParameters& parameters, double range, double& absolute_bound);
+
+        template <typename T>
+        H5ZIOParameters choose_codec(const std::vector<T>& sample, std::vector<hsize_t>& sample_dims, std::vector<hsize_t>& block,
+                                     H5ZIOParameters& parameters);
+
+        /**
+         * @brief Intervalo de busca do limite de erro. lower é o extremo de menor
+         *        compressão e upper o de maior compressão
+         */
+        void search_interval(H5ZIOParameters& parameters, double range, double& lower, double& upper, bool& logarithmic);
+
+        /**
+         * @brief Guarda o limite x se ele for o melhor até aqui. Limites que
+         *        atingem o alvo (taxa ou PSNR maior ou igual) têm preferência
+         */
+        void select(double x, double sample_ratio, double sample_psnr, double error, bool safe);
+
+        /**
+         * @brief Comprime a amostra e mede a taxa de compressão e, se range > 0, 
+         *        o PSNR e o maior erro absoluto da amostra decodificada.
+         *        Se seconds não for nulo, recebe o tempo de codificação dos chunks
+         */
+        template <typename T>
+        void measure(const std::vector<T>& sample, std::vector<hsize_t>& sample_dims, H5ZIOParameters& parameters,
+                     double range, double& sample_ratio, double& sample_psnr, double& max_error, double* seconds = nullptr);
+
+        // tempo de codificação dos chunks da amostra, fora do pipeline do HDF5
+        double encode_seconds(H5ZioChunkCodec& codec, const void* sample, size_t type_size, std::vector<hsize_t>& sample_dims);
+
+        double  tolerance;
+        int     max_iterations;
+        double  sample_fraction;
+        hsize_t max_sample_size;
+
+        double  bound;
+        double  ratio;
+        double  psnr;
+        double  throughput;
+        int     iterations;
+        double  best_error;
+        bool    best_safe;
+};
+
+template <typename T>
+H5ZIOParameters H5ZioTuner::tune(const T* data, hsize_t ndims, const hsize_t dims[], H5ZIOParameters parameters,
+                                 H5ZIO::Target target, double value)
+{
+    static_assert(std::is_floating_point<T>::value, "Error bound tuning requires floating point data");
+    if(value <= 0)
+    {
+        throw std::runtime_error("Tuning target must be positive");
+    }
+
+    // amostra: blocos empilhados na primeira dimensão
+    std::vector<T>       sample;
+    std::vector<hsize_t> block, sample_dims;
+    gather_sample<T>([&](const hsize_t offset[], const hsize_t count[], T* block_data) {
+                         std::vector<hsize_t> start(ndims, 0);
+                         H5ZIO::copy_box(ndims, sizeof(T), count, data, dims, offset, block_data, count, start.data());
+                     }, ndims, dims, parameters, sample, block, sample_dims);
+
+    double minimum = sample[0], maximum = sample[0];
+    for(size_t i = 1; i < sample.size(); i++)
+    {
+        if(sample[i] < minimum) minimum = sample[i];
+        if(sample[i] > maximum) maximum = sample[i];
+    }
+    double range = maximum - minimum;
+
+    // dados constantes: a escala do intervalo é a magnitude dos valores
+    double scale = range > 0 ? range : std::max(std::max(std::fabs(minimum), std::fabs(maximum)), 1.0);
+    double lower, upper;
+    bool   logarithmic;
+    search_interval(parameters, scale, lower, upper, logarithmic);
+
+    // cada chunk da amostra é um bloco, como os chunks do dataset completo
+    H5ZIOParameters trial(parameters);
+    trial.set_chunk_dimensions(ndims, block.data());
+
+    // a taxa de compressão não precisa da amostra descomprimida
+    double psnr_range = target == H5ZIO::Target::PSNR ? range : 0.0;
+
+    best_error = std::numeric_limits<double>::infinity();
+    best_safe  = false;
+    bound      = lower;
+    ratio      = 0.0;
+    psnr       = 0.0;
+    if(range <= 0)
+    {
+        // qualquer limite positivo reconstrói dados constantes: o menor (quase sem perdas) é usado
+        double max_error;
+        trial.set_error_bound_value(lower);
+        measure(sample, sample_dims, trial, 0.0, ratio, psnr, max_error);
+        psnr       = std::numeric_limits<double>::infinity();
+        iterations = 1;
+        parameters.set_error_bound_value(lower);
+        return parameters;
+    }
+
+    for(iterations = 0; iterations < max_iterations; )
+    {
+        double x = logarithmic ? std::sqrt(lower * upper) : 0.5 * (lower + upper);
+        trial.set_error_bound_value(x);
+
+        double sample_ratio, sample_psnr, max_error;
+        measure(sample, sample_dims, trial, psnr_range, sample_ratio, sample_psnr, max_error);
+        iterations++;
+
+        double metric = target == H5ZIO::Target::RATIO ? sample_ratio : sample_psnr;
+        double error  = std::fabs(metric - value) / value;
+        select(x, sample_ratio, sample_psnr, error, metric >= value);
+        if(error <= tolerance)
+        {
+            break;
+        }
+        // taxa abaixo do alvo ou PSNR acima do alvo: mais compressão
+        bool more = target == H5ZIO::Target::RATIO ? metric < value : metric > value;
+        if(more) lower = x;
+        else     upper = x;
+    }
+
+    parameters.set_error_bound_value(bound);
+    return parameters;
+}
+
+template <typename T>
+H5ZIOParameters H5ZioTuner::select_codec(const T* data, hsize_t ndims, const hsize_t dims[], H5ZIOParameters parameters)
+{
+    std::vector<T>       sample;
+    std::vector<hsize_t> block, sample_dims;
+    gather_sample<T>([&](const hsize_t offset[], const hsize_t count[], T* block_data) {
+                         std::vector<hsize_t> start(ndims, 0);
+                         H5ZIO::copy_box(ndims, sizeof(T), count, data, dims, offset, block_data, count, start.data());
+                     }, ndims, dims, parameters, sample, block, sample_dims);
+    return choose_codec(sample, sample_dims, block, parameters);
+}
+
+template <typename T>
+H5ZIOParameters H5ZioTuner::select_codec(H5Zio& input, std::string dataset, H5ZIOParameters parameters)
+{
+    H5Dimensions dims = input.dataset_dimensions(dataset);
+    std::vector<T>       sample;
+    std::vector<hsize_t> block, sample_dims;
+    gather_sample<T>([&](const hsize_t offset[], const hsize_t count[], T* block_data) {
+                         input.read_region<T>(dataset, offset, count, nullptr, block_data);
+                     }, dims.get_ndims(), dims.get_dims(), parameters, sample, block, sample_dims);
+    return choose_codec(sample, sample_dims, block, parameters);
+}
+
+template <typename T, typename Reader>
+void H5ZioTuner::gather_sample(Reader read_block, hsize_t ndims, const hsize_t dims[], H5ZIOParameters& parameters,
+                               std::vector<T>& sample, std::vector<hsize_t>& block, std::vector<hsize_t>& sample_dims)
+{
+    std::vector<std::vector<hsize_t> > offsets;
+    plan_sample(parameters, ndims, dims, sizeof(T), block, offsets);
+
+    // os blocos têm as mesmas dimensões da amostra, exceto a primeira: cada um é contíguo
+    hsize_t block_size = 1;
+    for(hsize_t i = 0; i < ndims; i++)
+    {
+        block_size *= block[i];
+    }
+    sample_dims = block;
+    sample_dims[0] *= offsets.size();
+    sample.resize(block_size * offsets.size());
+    for(size_t k = 0; k < offsets.size(); k++)
+    {
+        read_block(offsets[k].data(), block.data(), sample.data() + k * block_size);
+    }
+}
+
+template <typename T>
+H5ZIOParameters H5ZioTuner::choose_codec(const std::vector<T>& sample, std::vector<hsize_t>& sample_dims, std::vector<hsize_t>& block,
+                                         H5ZIOParameters& parameters)
+{
+    const double megabyte = 1.0E6;
+    double sample_mb = sample.size() * sizeof(T) / megabyte;
+
+    double minimum = sample[0], maximum = sample[0];
+    for(size_t i = 1; i < sample.size(); i++)
+    {
+        if(sample[i] < minimum) minimum = sample[i];
+        if(sample[i] > maximum) maximum = sample[i];
+    }
+    double range = static_cast<double>(maximum) - static_cast<double>(minimum);
+
+    double absolute_bound;
+    std::vector<H5ZIOParameters> candidates = codec_candidates(parameters, range, absolute_bound);
+    int    chosen = -1, fastest = -1;
+    double best_ratio = 0.0, best_speed = 0.0, fastest_speed = 0.0, fastest_ratio = 0.0;
+    iterations = 0;
+    for(size_t c = 0; c < candidates.size(); c++)
+    {
+        H5ZIOParameters trial(candidates[c]);
+        trial.set_chunk_dimensions(sample_dims.size(), block.data());
+        bool lossless = trial.get_compression_type() == H5ZIO::Type::GZIP;
+
+        double sample_ratio, sample_psnr, max_error, seconds;
+        try
+        {
+            // somente as amostras com perdas são decodificadas, para conferir o erro
+            measure(sample, sample_dims, trial, lossless ? 0.0 : range, sample_ratio, sample_psnr, max_error, &seconds);
+        }
+        catch(const std::runtime_error&)
+        {
+            // filtro compilado mas não registrado no HDF5
+            continue;
+        }
+        iterations++;
+        if(!lossless && max_error > absolute_bound)
+        {
+            continue;
+        }
+
+        double speed = seconds > 0 ? sample_mb / seconds : std::numeric_limits<double>::infinity();
+        if(speed >= parameters.get_min_throughput())
+        {
+            // mesma qualidade ou melhor: o GZIP é mantido salvo ganho maior que a tolerância
+            bool chosen_lossless = chosen >= 0 && candidates[chosen].get_compression_type() == H5ZIO::Type::GZIP;
+            double margin = lossless ? 1.0 / (1.0 + tolerance) : (chosen_lossless ? 1.0 + tolerance : 1.0);
+            if(chosen < 0 || sample_ratio > best_ratio * margin)
+            {
+                chosen     = c;
+                best_ratio = sample_ratio;
+                best_speed = speed;
+            }
+        }
+        if(fastest < 0 || speed > fastest_speed)
+        {
+            fastest       = c;
+            fastest_speed = speed;
+            fastest_ratio = sample_ratio;
+        }
+    }
+    if(fastest < 0)
+    {
+        throw std::runtime_error("No compression filter is available");
+    }
+    if(chosen < 0)
+    {
+        chosen     = fastest;
+        best_ratio = fastest_ratio;
+        best_speed = fastest_speed;
+    }
+    ratio      = best_ratio;
+    throughput = best_speed;
+    psnr       = 0.0;
+    return candidates[chosen];
+}
+
+template <typename T>
+void H5ZioTuner::measure(const std::vector<T>& sample, std::vector<hsize_t>& sample_dims, H5ZIOParameters& parameters,
+                         double range, double& sample_ratio, double& sample_psnr, double& max_error, double* seconds)
+{
+    // nome único: o HDF5 identifica arquivos do driver core pelo nome
+    static std::atomic<unsigned int> trials(0);
+
+    // a amostra não é verificada: a medida de vazão é só da compressão
+    H5ZIOParameters trial(parameters);
+    trial.set_verify(false);
+
+    H5Zio h5zio;
+    h5zio.set_verbose_level(0);
+    h5zio.open_memory("tuner_" + std::to_string(trials++) + ".h5");
+    auto start = std::chrono::steady_clock::now();
+    h5zio.write_dataset<T>("sample", sample.data(), sample_dims.size(), sample_dims.data(), &trial);
+    double write_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    hid_t   dataset_id = H5Dopen(h5zio.get_file_id(), "sample", H5P_DEFAULT);
+    hsize_t stored     = H5Dget_storage_size(dataset_id);
+    if(seconds != nullptr)
+    {
+        // o tempo de escrita inclui a criação do arquivo e do dataset: só é usado
+        // se os chunks não puderem ser codificados diretamente
+        H5ZioChunkCodec codec(dataset_id);
+        *seconds = codec.is_supported() ? encode_seconds(codec, sample.data(), sizeof(T), sample_dims) : write_seconds;
+    }
+    H5Dclose(dataset_id);
+
+    sample_ratio = stored > 0 ? static_cast<double>(sample.size() * sizeof(T)) / stored : 0.0;
+    sample_psnr  = 0.0;
+    max_error    = 0.0;
+    if(range <= 0)
+    {
+        h5zio.close();
+        return;
+    }
+
+    std::vector<T> decoded;
+    h5zio.read_dataset<T>("sample", decoded);
+    h5zio.close();
+
+    double mse = 0.0;
+    for(size_t i = 0; i < sample.size(); i++)
+    {
+        double diff = static_cast<double>(sample[i]) - static_cast<double>(decoded[i]);
+        mse += diff * diff;
+        max_error = std::max(max_error, std::fabs(diff));
+    }
+    mse /= sample.size();
+
+    sample_psnr  = mse > 0 ? 20.0 * std::log10(range) - 10.0 * std::log10(mse) : std::numeric_limits<double>::infinity();
+}
+
+#endif     /* H5ZIO_TUNER_H__ */
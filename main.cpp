@@ -15,7 +15,7 @@ void print_help()
     cout << "Options:" << endl;
     cout << "  -h  : Print this help message" << endl;
     cout << "  -c  : Compress the output file" << endl;
-    cout << "  -d  : Decompress the output file" << endl;
+    cout << "  -d  : Decompress the input file into contiguous datasets without filters" << endl;
     cout << "  -f <filter>: Specify the filter to use" << endl;
     cout << "        filters available: " << std::endl;
 #ifdef H5ZIO_HAS_GZIP
@@ -26,6 +26,19 @@ void print_help()
 #endif
 #ifdef H5ZIO_HAS_ZFP
     cout << "          zfp" << std::endl;
+#endif
+    cout << "          auto (best ratio per dataset among the filters above)" << std::endl;
+#ifdef H5ZIO_HAS_GZIP
+    cout << "          fast     (shuffle + deflate 1)" << std::endl;
+    cout << "          balanced (shuffle + deflate 4)" << std::endl;
+    cout << "          checked  (shuffle + deflate 4 + fletcher32)" << std::endl;
+#endif
+    cout << "  -I <filter>: Specify the filter for integer datasets (default: none)" << endl;
+    cout << "        filters available: " << std::endl;
+    cout << "          none" << std::endl;
+    cout << "          intpack (lossless, readable only with h5zio)" << std::endl;
+#ifdef H5ZIO_HAS_GZIP
+    cout << "          gzip" << std::endl;
 #endif
     cout << "  -t <type>: Specify the compression type id" << endl;
 #ifdef H5ZIO_HAS_SZ
@@ -43,6 +56,13 @@ void print_help()
     cout << "          1:ZFP_REVERSIBLE" << std::endl;
 #endif
     cout << "  -e <value>: Specify the error bound value" << endl;
+    cout << "  -l <level>: Deflate level of the gzip filter, 1-9 (default: 9)" << endl;
+    cout << "  -m <MB>: Memory budget used to stream large datasets (default: 256)" << endl;
+    cout << "  -n <threads>: Number of compression threads (default: 1)" << endl;
+    cout << "  -s <MB/s>: Minimum compression throughput for the auto filter (default: 0)" << endl;
+    cout << "  -p <file>: Compression policy with per-dataset parameters by path pattern" << endl;
+    cout << "  -k : Verify the error bound of every written chunk; violating chunks are stored losslessly" << endl;
+    cout << "  -T <file>: Save a Chrome/Perfetto trace of the compression internals" << endl;
     cout << "  -v : Print verbose output" << endl;
     cout << "  -V : Print the version number" << endl;
 }
@@ -98,6 +118,9 @@ void print_help()
 int main(int argc, char* argv[])
 {
     bool compress = false;
+    bool decompress = false;
+    hsize_t memory_budget = H5ZIO::DEFAULT_MEMORY_BUDGET;
+    unsigned int num_threads = 1;
     H5Zio  input;
     H5Zio  output;
 
@@ -126,7 +149,7 @@ int main(int argc, char* argv[])
     if (cl.search(2, "--decompress", "-d"))
     {
         compress = false;
-
+        decompress = true;
     }
 
     if (cl.search(2, "--verbose", "-v"))
@@ -151,6 +174,22 @@ int main(int argc, char* argv[])
         {
             write_parameters_float.set_compression_type(H5ZIO::Type::ZFP);
         }
+        else if (filter == "auto")
+        {
+            write_parameters_float.set_compression_type(H5ZIO::Type::AUTO);
+        }
+        else if (filter == "fast")
+        {
+            write_parameters_float.set_filter_preset(H5ZIO::FilterPreset::FAST);
+        }
+        else if (filter == "balanced")
+        {
+            write_parameters_float.set_filter_preset(H5ZIO::FilterPreset::BALANCED);
+        }
+        else if (filter == "checked")
+        {
+            write_parameters_float.set_filter_preset(H5ZIO::FilterPreset::CHECKED);
+        }
         else
         {
             cout << "Unknown filter: " << filter << endl;
@@ -159,6 +198,23 @@ int main(int argc, char* argv[])
     }
 
     write_parameters_integer.set_compression_type(H5ZIO::Type::NONE);
+    if (cl.search(2, "--integer-filter", "-I"))
+    {
+        string integer_filter = cl.next((const char*)"none");
+        if (integer_filter == "intpack")
+        {
+            write_parameters_integer.set_compression_type(H5ZIO::Type::INTPACK);
+        }
+        else if (integer_filter == "gzip")
+        {
+            write_parameters_integer.set_compression_type(H5ZIO::Type::GZIP);
+        }
+        else if (integer_filter != "none")
+        {
+            cout << "Unknown integer filter: " << integer_filter << endl;
+            return 1;
+        }
+    }
 
     if (cl.search(2, "--error-bound-type", "-t"))
     {
@@ -186,6 +242,55 @@ int main(int argc, char* argv[])
         write_parameters_float.set_error_bound_value(error_bound);
     }
 
+    if (cl.search(2, "--gzip-level", "-l"))
+    {
+        int level = cl.next(9);
+        if(level < 1 || level > 9)
+        {
+            cout << "Deflate level must be between 1 and 9" << endl;
+            return 1;
+        }
+        write_parameters_float.set_gzip_level(level);
+    }
+
+    if (cl.search(2, "--memory-budget", "-m"))
+    {
+        double megabytes = cl.next(256.0);
+        if(megabytes <= 0)
+        {
+            cout << "Memory budget must be positive" << endl;
+            return 1;
+        }
+        memory_budget = static_cast<hsize_t>(megabytes * 1024 * 1024);
+    }
+
+    if (cl.search(2, "--threads", "-n"))
+    {
+        int threads = cl.next(1);
+        if(threads < 1)
+        {
+            cout << "Number of threads must be positive" << endl;
+            return 1;
+        }
+        num_threads = threads;
+    }
+
+    if (cl.search(2, "--min-throughput", "-s"))
+    {
+        double throughput = cl.next(0.0);
+        if(throughput < 0)
+        {
+            cout << "Minimum throughput must not be negative" << endl;
+            return 1;
+        }
+        write_parameters_float.set_min_throughput(throughput);
+    }
+
+    if (cl.search(2, "--verify", "-k"))
+    {
+        write_parameters_float.set_verify(true);
+    }
+
     if(!cl.search(2, "-i", "-o"))
     {
         cout << "Input and output files must be specified" << endl;
@@ -204,9 +309,34 @@ int main(int argc, char* argv[])
         output_file = cl.next((const char*)"out.h5");
     }
 
+    // regras do arquivo de política têm precedência sobre os parâmetros da linha de comando
+    H5ZioPolicy policy;
+    policy.set_default(write_parameters_float, H5ZIO::Elements::FLOAT);
+    policy.set_default(write_parameters_integer, H5ZIO::Elements::INTEGER);
+    if (cl.search(2, "--policy", "-p"))
+    {
+        string policy_file = cl.next((const char*)"");
+        policy.load_config(policy_file);
+    }
+
+    string trace_file;
+    if (cl.search(2, "--trace", "-T"))
+    {
+        trace_file = cl.next((const char*)"h5zio_trace.json");
+        H5ZioTrace::enable();
+    }
+
     if(compress)
     {
-        H5ZIO::compress(input_file, output_file, write_parameters_float);
+        H5ZIO::compress(input_file, output_file, policy, memory_budget, num_threads);
+    }
+    else if(decompress)
+    {
+        H5ZIO::decompress(input_file, output_file, num_threads, memory_budget);
+    }
+    if(!trace_file.empty())
+    {
+        H5ZioTrace::save(trace_file);
     }
     return 0;
 }
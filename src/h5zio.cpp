@@ -1,22 +1,32 @@
 
 #include "h5zio.h"
+#include "h5zio_codec.h"
+#include "h5zio_thread_pool.h"
+#include "h5zio_tuner.h"
+#include "h5zio_trace.h"
 
 #include <fstream>
 #include <sstream>
 
 #include <stack>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
 #include <unordered_set>
+#include <fnmatch.h>
 
 #ifdef H5ZIO_HAS_SZ
 #include "H5Z_SZ.h"
-#define MAX_CHUNK_SIZE 4294967295 // 2^32-1
 #endif // SZ_HDF5
 
 #ifdef H5ZIO_HAS_ZFP
 #include "H5Zzfp.h"
 #endif // ZFP_HDF5
 
-inline hsize_t compute_size(hsize_t ndims, hsize_t dims[])
+inline hsize_t compute_size(hsize_t ndims, const hsize_t dims[])
 {
     hsize_t size = 1;
     for(int i = 0; i < ndims; i++)
@@ -26,7 +36,7 @@ inline hsize_t compute_size(hsize_t ndims, hsize_t dims[])
     return size;
 }
 
-inline hsize_t compute_size(std::vector<hsize_t> dims)
+inline hsize_t compute_size(const std::vector<hsize_t>& dims)
 {
     hsize_t size = 1;
     for(int i = 0; i < dims.size(); i++)
@@ -40,6 +50,12 @@ H5ZIOParameters::H5ZIOParameters()
 {
     // Initialize the parameters
     this->gzip_level = 9;
+    this->chunk_mode = H5ZIO::ChunkMode::AUTO;
+    this->chunk_size = H5ZIO::DEFAULT_CHUNK_SIZE;
+    this->min_throughput = 0.0;
+    this->verify = false;
+    std::copy(H5ZIO::default_error_bound_values, H5ZIO::default_error_bound_values + H5ZIO::NUM_ERROR_BOUNDS, 
+              this->error_bound_values);
 #ifdef H5ZIO_HAS_ZFP
     type             = H5ZIO::Type::ZFP;
     error_bound_type = static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY);
@@ -101,7 +117,7 @@ void H5ZIOParameters::set_error_bound_type(H5ZIO::ZFP::ErrorBound type)
 
 void H5ZIOParameters::set_error_bound_value(double value)
 {
-    H5ZIO::error_bound_values[this->error_bound_type] = value;
+    this->error_bound_values[this->error_bound_type] = value;
 }
 
 
@@ -133,7 +149,7 @@ double H5ZIOParameters::get_error_bound_value(H5ZIO::SZ2::ErrorBound type)
         throw std::runtime_error("Error bounds are only available for SZ compression");
     }
     int idx = static_cast<int>(type);
-    return H5ZIO::error_bound_values[idx];
+    return this->error_bound_values[idx];
 }
 
 double H5ZIOParameters::get_error_bound_value(H5ZIO::ZFP::ErrorBound type)
@@ -143,10 +159,48 @@ double H5ZIOParameters::get_error_bound_value(H5ZIO::ZFP::ErrorBound type)
         throw std::runtime_error("Error bounds are only available for ZFP compression");
     }
     int idx = static_cast<int>(type);
-    return H5ZIO::error_bound_values[idx];
+    return this->error_bound_values[idx];
 }
 
 
+bool H5ZIOParameters::operator==(const H5ZIOParameters& other) const
+{
+    return type == other.type && error_bound_type == other.error_bound_type && gzip_level == other.gzip_level &&
+           std::equal(error_bound_values, error_bound_values + H5ZIO::NUM_ERROR_BOUNDS, other.error_bound_values) &&
+           chunk_mode == other.chunk_mode && chunk_size == other.chunk_size && chunk_dims == other.chunk_dims &&
+           min_throughput == other.min_throughput && verify == other.verify && filters == other.filters;
+}
+
+size_t H5ZIOParameters::hash() const
+{
+    // combinação no estilo boost::hash_combine
+    size_t seed = 0;
+    auto combine = [&seed](size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+    combine(std::hash<int>()(static_cast<int>(type)));
+    combine(std::hash<int>()(error_bound_type));
+    combine(std::hash<int>()(gzip_level));
+    for(int i = 0; i < H5ZIO::NUM_ERROR_BOUNDS; i++)
+    {
+        combine(std::hash<double>()(error_bound_values[i]));
+    }
+    combine(std::hash<int>()(static_cast<int>(chunk_mode)));
+    combine(std::hash<hsize_t>()(chunk_size));
+    for(hsize_t extent : chunk_dims)
+    {
+        combine(std::hash<hsize_t>()(extent));
+    }
+    combine(std::hash<double>()(min_throughput));
+    combine(std::hash<bool>()(verify));
+    for(const H5ZIO::FilterStep& step : filters)
+    {
+        combine(std::hash<int>()(static_cast<int>(step.first)));
+        combine(std::hash<int>()(step.second));
+    }
+    return seed;
+}
+
 int H5ZIOParameters::get_error_bound_type()
 {
     return this->error_bound_type;
@@ -167,6 +221,214 @@ int H5ZIOParameters::get_gzip_level()
     return gzip_level;
 }
 
+void H5ZIOParameters::set_gzip_level(int level)
+{
+    if(level < 1 || level > 9)
+    {
+        throw std::runtime_error("Invalid deflate level");
+    }
+    gzip_level = level;
+}
+
+H5ZIOParameters& H5ZIOParameters::add_filter(H5ZIO::Filter filter, int argument)
+{
+    if(filter == H5ZIO::Filter::DEFLATE && (argument < 0 || argument > 9))
+    {
+        throw std::runtime_error("Invalid deflate level");
+    }
+    if(filter == H5ZIO::Filter::SCALEOFFSET && argument < 0)
+    {
+        throw std::runtime_error("Invalid scale-offset factor");
+    }
+    // scale-offset e n-bit interpretam os elementos: não podem receber bytes reordenados ou comprimidos
+    if(filter == H5ZIO::Filter::SCALEOFFSET || filter == H5ZIO::Filter::NBIT)
+    {
+        for(const H5ZIO::FilterStep& step : filters)
+        {
+            if(step.first == H5ZIO::Filter::SHUFFLE || step.first == H5ZIO::Filter::DEFLATE)
+            {
+                throw std::runtime_error(H5ZIO::filter_names[static_cast<int>(filter)] + " must precede SHUFFLE and DEFLATE");
+            }
+        }
+    }
+    // argumento 0 do deflate: nível definido em set_gzip_level
+    filters.push_back(H5ZIO::FilterStep(filter, filter == H5ZIO::Filter::DEFLATE && argument == 0 ? gzip_level : argument));
+    type = H5ZIO::Type::CHAIN;
+    return *this;
+}
+
+void H5ZIOParameters::clear_filters()
+{
+    filters.clear();
+}
+
+void H5ZIOParameters::set_filter_preset(H5ZIO::FilterPreset preset)
+{
+    filters.clear();
+    switch(preset)
+    {
+        case H5ZIO::FilterPreset::FAST:
+            add_filter(H5ZIO::Filter::SHUFFLE).add_filter(H5ZIO::Filter::DEFLATE, 1);
+            break;
+        case H5ZIO::FilterPreset::BALANCED:
+            add_filter(H5ZIO::Filter::SHUFFLE).add_filter(H5ZIO::Filter::DEFLATE, 4);
+            break;
+        case H5ZIO::FilterPreset::CHECKED:
+            add_filter(H5ZIO::Filter::SHUFFLE).add_filter(H5ZIO::Filter::DEFLATE, 4).add_filter(H5ZIO::Filter::FLETCHER32);
+            break;
+    }
+    type = H5ZIO::Type::CHAIN;
+}
+
+void H5ZIOParameters::set_chunk_dimensions(hsize_t ndims, const hsize_t dims[])
+{
+    if(ndims == 0)
+    {
+        throw std::runtime_error("Invalid chunk dimensions");
+    }
+    hsize_t size = 1;
+    for(int i = 0; i < ndims; i++)
+    {
+        if(dims[i] == 0)
+        {
+            throw std::runtime_error("Invalid chunk dimensions");
+        }
+        size *= dims[i];
+    }
+    // o limite em bytes depende do tipo e é verificado em plan_chunk_dimensions;
+    // aqui só se descartam chunks que o excedem mesmo com elementos de um byte
+    if(size > H5ZIO::MAX_CHUNK_SIZE)
+    {
+        throw std::runtime_error("Chunk is larger than the HDF5 chunk size limit");
+    }
+    this->chunk_dims.assign(dims, dims + ndims);
+    this->chunk_mode = H5ZIO::ChunkMode::EXPLICIT;
+}
+
+void H5ZIOParameters::set_chunk_size(hsize_t bytes)
+{
+    if(bytes == 0)
+    {
+        throw std::runtime_error("Invalid chunk size");
+    }
+    this->chunk_size = std::min(bytes, H5ZIO::MAX_CHUNK_SIZE);
+    this->chunk_mode = H5ZIO::ChunkMode::AUTO;
+}
+
+void H5ZIOParameters::set_chunk_mode(H5ZIO::ChunkMode mode)
+{
+    if(mode == H5ZIO::ChunkMode::EXPLICIT && chunk_dims.empty())
+    {
+        throw std::runtime_error("Chunk dimensions are not defined");
+    }
+    this->chunk_mode = mode;
+}
+
+H5ZIO::ChunkMode H5ZIOParameters::get_chunk_mode()
+{
+    return this->chunk_mode;
+}
+
+hsize_t H5ZIOParameters::get_chunk_size()
+{
+    return this->chunk_size;
+}
+
+void H5ZIOParameters::set_min_throughput(double mb_per_second)
+{
+    if(mb_per_second < 0)
+    {
+        throw std::runtime_error("Minimum throughput must not be negative");
+    }
+    min_throughput = mb_per_second;
+}
+
+double H5ZIOParameters::get_min_throughput()
+{
+    return min_throughput;
+}
+
+void H5ZIOParameters::set_verify(bool enabled)
+{
+    verify = enabled;
+}
+
+bool H5ZIOParameters::get_verify()
+{
+    return verify;
+}
+
+// aresta do bloco de compressão preferido por cada compressor
+hsize_t H5ZIOParameters::block_edge(hsize_t ndims)
+{
+    if(type == H5ZIO::Type::ZFP)
+    {
+        // ZFP comprime blocos independentes de 4^d valores
+        return 4;
+    }
+    if(type == H5ZIO::Type::SZ2)
+    {
+        // blocos usados pelo preditor por regressão do SZ2
+        if(ndims == 1) return 128;
+        if(ndims == 2) return 12;
+        return 6;
+    }
+    return 1;
+}
+
+void H5ZIOParameters::plan_chunk_dimensions(hsize_t ndims, const hsize_t dims[], hsize_t type_size, hsize_t chunk[])
+{
+    if(chunk_mode == H5ZIO::ChunkMode::EXPLICIT)
+    {
+        if(chunk_dims.size() != ndims)
+        {
+            throw std::runtime_error("Chunk rank does not match the dataset rank");
+        }
+        // um chunk não pode ser maior que um dataset de tamanho fixo
+        hsize_t size = 1;
+        for(int i = 0; i < ndims; i++)
+        {
+            chunk[i] = std::max<hsize_t>(1, std::min(chunk_dims[i], dims[i]));
+            size    *= chunk[i];
+        }
+        if(size > H5ZIO::MAX_CHUNK_SIZE / std::max<hsize_t>(1, type_size))
+        {
+            throw std::runtime_error("Chunk is larger than the HDF5 chunk size limit");
+        }
+        return;
+    }
+
+    hsize_t target = (chunk_mode == H5ZIO::ChunkMode::SINGLE) ? H5ZIO::MAX_CHUNK_SIZE : chunk_size;
+    hsize_t target_elements = std::max<hsize_t>(1, std::min(target, H5ZIO::MAX_CHUNK_SIZE) / std::max<hsize_t>(1, type_size));
+    hsize_t block = block_edge(ndims);
+
+    hsize_t size = 1;
+    for(int i = 0; i < ndims; i++)
+    {
+        chunk[i] = std::max<hsize_t>(1, dims[i]);
+        size *= chunk[i];
+    }
+
+    // divide a maior dimensão ao meio, mantendo-a múltipla do bloco, 
+    // até que o chunk caiba no tamanho alvo
+    while(size > target_elements)
+    {
+        int largest = 0;
+        for(int i = 1; i < ndims; i++)
+        {
+            if(chunk[i] > chunk[largest]) largest = i;
+        }
+        if(chunk[largest] <= block)
+        {
+            break;
+        }
+        hsize_t half = (chunk[largest] + 1) / 2;
+        half = ((half + block - 1) / block) * block;
+        size = (size / chunk[largest]) * half;
+        chunk[largest] = half;
+    }
+}
+
 void H5ZIOParameters::save_config(const std::string& filename)
 {
     std::ofstream out(filename);
@@ -179,7 +441,52 @@ void H5ZIOParameters::save_config(const std::string& filename)
     {
         out << "error_bound_type: " << H5ZIO::error_bound_names[error_bound_type] << std::endl;
     }
-    out << "error_bound_value: " << get_error_bound_value() << std::endl;
+    if(type == H5ZIO::Type::SZ2 || type == H5ZIO::Type::ZFP)
+    {
+        out << "error_bound_value: " << get_error_bound_value() << std::endl;
+    }
+    else if(type == H5ZIO::Type::AUTO)
+    {
+        out << "min_throughput: " << min_throughput << std::endl;
+    }
+    else if(type == H5ZIO::Type::GZIP)
+    {
+        out << "gzip_level: " << gzip_level << std::endl;
+    }
+    else if(type == H5ZIO::Type::CHAIN)
+    {
+        out << "filters: ";
+        for(int i = 0; i < filters.size(); i++)
+        {
+            out << (i > 0 ? "," : "") << H5ZIO::filter_names[static_cast<int>(filters[i].first)];
+            if(filters[i].first == H5ZIO::Filter::DEFLATE || filters[i].first == H5ZIO::Filter::SCALEOFFSET)
+            {
+                out << ":" << filters[i].second;
+            }
+        }
+        out << std::endl;
+    }
+    if(chunk_mode == H5ZIO::ChunkMode::EXPLICIT)
+    {
+        out << "chunk_dimensions: ";
+        for(int i = 0; i < chunk_dims.size(); i++)
+        {
+            out << (i > 0 ? "," : "") << chunk_dims[i];
+        }
+        out << std::endl;
+    }
+    else if(chunk_mode == H5ZIO::ChunkMode::SINGLE)
+    {
+        out << "chunk_size: single" << std::endl;
+    }
+    else
+    {
+        out << "chunk_size: " << chunk_size << std::endl;
+    }
+    if(verify)
+    {
+        out << "verify: 1" << std::endl;
+    }
     out.close();
 }
 
@@ -192,210 +499,1823 @@ void H5ZIOParameters::load_config(const std::string& filename)
         std::string key, value;
         std::istringstream iss(line);
         iss >> key >> value;
-        if(key == "compression_type:")
+        set_option(key, value);
+    }
+    in.close();
+}
+
+bool H5ZIOParameters::set_option(const std::string& key, const std::string& value)
+{
+    if(key == "compression_type:")
+    {
+        for(int i = 0; i < 7; i++)
         {
-            for(int i = 0; i < 4; i++)
+            if(value == H5ZIO::compression_type_names[i])
             {
-                if(value == H5ZIO::compression_type_names[i])
-                {
-                    type = static_cast<H5ZIO::Type>(i);
-                    break;
-                }
+                type = static_cast<H5ZIO::Type>(i);
+                break;
             }
         }
-        else if(key == "error_bound_type:")
+    }
+    else if(key == "error_bound_type:")
+    {
+        for(int i = 0; i < 8; i++)
         {
-            for(int i = 0; i < 8; i++)
+            if(value == H5ZIO::error_bound_names[i])
             {
-                if(value == H5ZIO::error_bound_names[i])
-                {
-                    error_bound_type = i;
-                    break;
-                }
+                error_bound_type = i;
+                break;
+            }
+        }
+    }
+    else if(key == "error_bound_value:")
+    {
+        set_error_bound_value(std::stod(value));
+    }
+    else if(key == "min_throughput:")
+    {
+        set_min_throughput(std::stod(value));
+    }
+    else if(key == "gzip_level:")
+    {
+        set_gzip_level(std::stoi(value));
+    }
+    else if(key == "filters:")
+    {
+        // lista "FILTRO[:argumento],...", por exemplo "SHUFFLE,DEFLATE:4,FLETCHER32"
+        clear_filters();
+        std::istringstream fss(value);
+        std::string item;
+        while(std::getline(fss, item, ','))
+        {
+            std::string name     = item.substr(0, item.find(':'));
+            int         argument = item.find(':') != std::string::npos ? std::stoi(item.substr(item.find(':') + 1)) : 0;
+            int         filter   = 0;
+            while(filter < 5 && H5ZIO::filter_names[filter] != name) filter++;
+            if(filter == 5)
+            {
+                throw std::runtime_error("Unknown filter " + name);
             }
+            add_filter(static_cast<H5ZIO::Filter>(filter), argument);
+        }
+    }
+    else if(key == "verify:")
+    {
+        set_verify(value == "1" || value == "true" || value == "yes");
+    }
+    else if(key == "chunk_size:")
+    {
+        if(value == "single")
+        {
+            set_chunk_mode(H5ZIO::ChunkMode::SINGLE);
         }
-        else if(key == "error_bound_value:")
+        else
         {
-            set_error_bound_value(std::stod(value));
+            set_chunk_size(std::stoull(value));
         }
     }
-    in.close();
+    else if(key == "chunk_dimensions:")
+    {
+        std::vector<hsize_t> cdims;
+        std::istringstream dss(value);
+        std::string item;
+        while(std::getline(dss, item, ','))
+        {
+            cdims.push_back(std::stoull(item));
+        }
+        set_chunk_dimensions(cdims.size(), cdims.data());
+    }
+    else
+    {
+        return false;
+    }
+    return true;
 }
 
+H5ZioPolicy::H5ZioPolicy()
+{
+    integer_default.set_compression_type(H5ZIO::Type::NONE);
+}
 
-hid_t H5Zio::create_filter(H5ZIOParameters* params, hsize_t ndims, hsize_t dims[])
+void H5ZioPolicy::set_default(const H5ZIOParameters& parameters, H5ZIO::Elements elements)
 {
-    
-    hid_t avail = -1;
-    hid_t filter_id = H5Pcreate(H5P_DATASET_CREATE);
+    if(elements != H5ZIO::Elements::INTEGER)
+    {
+        float_default = parameters;
+    }
+    if(elements != H5ZIO::Elements::FLOAT)
+    {
+        integer_default = parameters;
+    }
+}
 
-    if(params->get_compression_type() == H5ZIO::Type::ZFP)
+void H5ZioPolicy::add_rule(const std::string& pattern, const H5ZIOParameters& parameters, H5ZIO::Elements elements)
+{
+    rules.push_back(rule(pattern, elements, parameters));
+}
+
+H5ZIOParameters* H5ZioPolicy::find(const std::string& dataset, bool floating)
+{
+    H5ZIOParameters* parameters = floating ? &float_default : &integer_default;
+    for(auto& r : rules)
     {
-        if(params->get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY))
+        H5ZIO::Elements elements = std::get<1>(r);
+        if((elements == H5ZIO::Elements::FLOAT && !floating) || (elements == H5ZIO::Elements::INTEGER && floating))
         {
-            unsigned cd_nelmts =  10;
-            unsigned int cd_values[10];
-            avail = H5Zfilter_avail(H5Z_FILTER_ZFP);
-            if(avail < 0)
+            continue;
+        }
+        // '*' também casa com '/': "*/velocity*" vale em qualquer grupo
+        if(fnmatch(std::get<0>(r).c_str(), dataset.c_str(), 0) == 0)
+        {
+            parameters = &std::get<2>(r);
+            break;
+        }
+    }
+    return parameters->get_compression_type() == H5ZIO::Type::NONE ? nullptr : parameters;
+}
+
+void H5ZioPolicy::load_config(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if(!in)
+    {
+        throw std::runtime_error("Failed to open policy file " + filename);
+    }
+
+    // linhas antes da primeira seção definem os parâmetros default dos datasets de ponto flutuante;
+    // cada seção [padrão tipo] parte desses parâmetros
+    H5ZIOParameters* current = &float_default;
+    std::string line;
+    while(std::getline(in, line))
+    {
+        std::string key, value;
+        std::istringstream iss(line);
+        iss >> key;
+        if(key.empty() || key[0] == '#')
+        {
+            continue;
+        }
+        if(key[0] == '[')
+        {
+            std::string section = line.substr(line.find('[') + 1, line.rfind(']') - line.find('[') - 1);
+            std::string pattern, kind;
+            std::istringstream sss(section);
+            sss >> pattern >> kind;
+
+            H5ZIO::Elements elements = H5ZIO::Elements::ANY;
+            if(kind == "float")
             {
-                throw std::runtime_error("ZFP filter is not available");
+                elements = H5ZIO::Elements::FLOAT;
             }
-            H5Pset_chunk(filter_id, ndims, dims);
-            double accuracy = params->get_error_bound_value(H5ZIO::ZFP::ErrorBound::ACCURACY);
-            H5Pset_zfp_accuracy_cdata(accuracy, cd_nelmts, cd_values);
-            H5Pset_filter(filter_id, H5Z_FILTER_ZFP, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
-            return filter_id;
-        } 
-        else if (params->get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::REVERSIBLE))
-        {
-            unsigned cd_nelmts =  10;
-            unsigned int cd_values[10];
-            avail = H5Zfilter_avail(H5Z_FILTER_ZFP);
-            if(avail < 0)
+            else if(kind == "integer")
             {
-                throw std::runtime_error("ZFP filter is not available");
+                elements = H5ZIO::Elements::INTEGER;
             }
-            H5Pset_chunk(filter_id, ndims, dims);
-            H5Pset_zfp_reversible_cdata(cd_nelmts, cd_values);
-            H5Pset_filter(filter_id, H5Z_FILTER_ZFP, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
-            return filter_id;
-        } else
+            else if(!kind.empty() && kind != "any")
+            {
+                throw std::runtime_error("Invalid element type in policy section: " + section);
+            }
+            add_rule(pattern, float_default, elements);
+            current = &std::get<2>(rules.back());
+            continue;
+        }
+        iss >> value;
+        if(!current->set_option(key, value))
         {
-            throw std::runtime_error("Invalid error bound type");
+            throw std::runtime_error("Invalid policy option: " + key);
         }
     }
-    else if (params->get_compression_type() == H5ZIO::Type::SZ2)
+    in.close();
+}
+
+// Disponibilidade dos filtros, consultada uma única vez por processo
+static bool filter_available(H5Z_filter_t filter)
+{
+    static std::mutex                   mutex;
+    static std::map<H5Z_filter_t, bool> available;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = available.find(filter);
+    if(it == available.end())
     {
-        unsigned int *cd_values = NULL;
-        size_t cd_nelmts = 0;
-        avail = H5Zfilter_avail(H5Z_FILTER_SZ);
-        if(avail < 0)
-        {
-            throw std::runtime_error("SZ filter is not available");
-        }
-        SZ_errConfigToCdArray(&cd_nelmts, &cd_values, params->get_sz_error_bound_id(), 
-                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::ABSOLUTE),
-                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::RELATIVE), 
-                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::PW_RELATIVE), 
-                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::SZ_PSNR));
-        H5Pset_chunk(filter_id, ndims, dims);
-        H5Pset_filter(filter_id, H5Z_FILTER_SZ, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
-        return filter_id;
+        it = available.emplace(filter, H5Zfilter_avail(filter) > 0).first;
+    }
+    return it->second;
+}
+
+hid_t H5Zio::create_filter(H5ZIOParameters* params, hid_t type, hsize_t ndims, hsize_t dims[], hsize_t type_size, 
+                          const hsize_t chunk_dims[])
+{
+    H5ZIO_TRACE("create_filter");
+    if(params->get_compression_type() == H5ZIO::Type::NONE)
+    {
+        return H5P_DEFAULT;
+    }
+    if(params->get_compression_type() == H5ZIO::Type::AUTO)
+    {
+        throw std::runtime_error("AUTO compression must be resolved with H5ZioTuner::select_codec");
+    }
+
+    std::vector<hsize_t> chunk(ndims);
+    if(chunk_dims != nullptr)
+    {
+        std::copy(chunk_dims, chunk_dims + ndims, chunk.begin());
+    }
+    else
+    {
+        params->plan_chunk_dimensions(ndims, dims, type_size, chunk.data());
+    }
+
+    // chave do cache: compressor, tipo e valores de erro, nível do gzip, formato dos chunks,
+    // encadeamento de filtros e classe dos elementos (o scale-offset depende dela)
+    std::vector<double> bounds;
+    if(params->get_compression_type() == H5ZIO::Type::ZFP && 
+       params->get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY))
+    {
+        bounds.push_back(params->get_error_bound_value(H5ZIO::ZFP::ErrorBound::ACCURACY));
+    }
+    else if(params->get_compression_type() == H5ZIO::Type::SZ2)
+    {
+        bounds.push_back(params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::ABSOLUTE));
+        bounds.push_back(params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::RELATIVE));
+        bounds.push_back(params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::PW_RELATIVE));
+        bounds.push_back(params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::SZ_PSNR));
+    }
+    filter_key key(static_cast<int>(params->get_compression_type()), params->get_error_bound_type(), 
+                   params->get_gzip_level(), bounds, chunk, params->get_filters(), static_cast<int>(H5Tget_class(type)));
+
+    auto cached = filter_cache.find(key);
+    if(cached != filter_cache.end())
+    {
+        return cached->second;
+    }
+    hid_t filter_id = build_filter(params, type, ndims, chunk.data());
+    filter_cache[key] = filter_id;
+    return filter_id;
+}
+
+hid_t H5Zio::build_filter(H5ZIOParameters* params, hid_t type, hsize_t ndims, const hsize_t chunk[])
+{
+    hid_t filter_id = H5Pcreate(H5P_DATASET_CREATE);
+
+    if(params->get_compression_type() == H5ZIO::Type::ZFP)
+    {
+        if(!filter_available(H5Z_FILTER_ZFP))
+        {
+            H5Pclose(filter_id);
+            throw std::runtime_error("ZFP filter is not available");
+        }
+        if(params->get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY))
+        {
+            unsigned cd_nelmts =  10;
+            unsigned int cd_values[10];
+            H5Pset_chunk(filter_id, ndims, chunk);
+            double accuracy = params->get_error_bound_value(H5ZIO::ZFP::ErrorBound::ACCURACY);
+            H5Pset_zfp_accuracy_cdata(accuracy, cd_nelmts, cd_values);
+            H5Pset_filter(filter_id, H5Z_FILTER_ZFP, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
+            return filter_id;
+        } 
+        else if (params->get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::REVERSIBLE))
+        {
+            unsigned cd_nelmts =  10;
+            unsigned int cd_values[10];
+            H5Pset_chunk(filter_id, ndims, chunk);
+            H5Pset_zfp_reversible_cdata(cd_nelmts, cd_values);
+            H5Pset_filter(filter_id, H5Z_FILTER_ZFP, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
+            return filter_id;
+        } else
+        {
+            H5Pclose(filter_id);
+            throw std::runtime_error("Invalid error bound type");
+        }
+    }
+    else if (params->get_compression_type() == H5ZIO::Type::SZ2)
+    {
+        unsigned int *cd_values = NULL;
+        size_t cd_nelmts = 0;
+        if(!filter_available(H5Z_FILTER_SZ))
+        {
+            H5Pclose(filter_id);
+            throw std::runtime_error("SZ filter is not available");
+        }
+        SZ_errConfigToCdArray(&cd_nelmts, &cd_values, params->get_sz_error_bound_id(), 
+                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::ABSOLUTE),
+                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::RELATIVE), 
+                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::PW_RELATIVE), 
+                                            params->get_error_bound_value(H5ZIO::SZ2::ErrorBound::SZ_PSNR));
+        H5Pset_chunk(filter_id, ndims, chunk);
+        H5Pset_filter(filter_id, H5Z_FILTER_SZ, H5Z_FLAG_MANDATORY, cd_nelmts, cd_values);
+        // o H5Pset_filter copia os parâmetros
+        free(cd_values);
+        return filter_id;
+    }
+    else if (params->get_compression_type() == H5ZIO::Type::GZIP)
+    {
+        if(!filter_available(H5Z_FILTER_DEFLATE))
+        {
+            H5Pclose(filter_id);
+            throw std::runtime_error("GZIP filter is not available");
+        }
+        H5Pset_chunk(filter_id, ndims, chunk);
+        H5Pset_deflate(filter_id, params->get_gzip_level());
+        return filter_id;
+    }
+    else if (params->get_compression_type() == H5ZIO::Type::INTPACK)
+    {
+        if(!filter_available(H5ZIO::FILTER_INTPACK))
+        {
+            H5Pclose(filter_id);
+            throw std::runtime_error("INTPACK filter is not available");
+        }
+        // opcional: chunks que não diminuem são gravados sem o filtro
+        H5Pset_chunk(filter_id, ndims, chunk);
+        H5Pset_filter(filter_id, H5ZIO::FILTER_INTPACK, H5Z_FLAG_OPTIONAL, 0, NULL);
+        return filter_id;
+    }
+    else if (params->get_compression_type() == H5ZIO::Type::CHAIN)
+    {
+        H5Pset_chunk(filter_id, ndims, chunk);
+        bool floating = H5Tget_class(type) == H5T_FLOAT;
+        for(const H5ZIO::FilterStep& step : params->get_filters())
+        {
+            herr_t status = 0;
+            switch(step.first)
+            {
+                case H5ZIO::Filter::SHUFFLE:
+                    status = H5Pset_shuffle(filter_id);
+                    break;
+                case H5ZIO::Filter::DEFLATE:
+                    status = filter_available(H5Z_FILTER_DEFLATE) ? H5Pset_deflate(filter_id, step.second) : -1;
+                    break;
+                case H5ZIO::Filter::SCALEOFFSET:
+                    // inteiros: argumento 0 calcula a largura mínima de cada chunk (H5Z_SO_INT_MINBITS_DEFAULT);
+                    // ponto flutuante: 0 arredondaria os valores para inteiros, o fator deve ser explícito
+                    if(floating && step.second == 0)
+                    {
+                        H5Pclose(filter_id);
+                        throw std::runtime_error("SCALEOFFSET on floating point data requires a decimal scale factor");
+                    }
+                    status = H5Pset_scaleoffset(filter_id, floating ? H5Z_SO_FLOAT_DSCALE : H5Z_SO_INT, step.second);
+                    break;
+                case H5ZIO::Filter::NBIT:
+                    status = H5Pset_nbit(filter_id);
+                    break;
+                case H5ZIO::Filter::FLETCHER32:
+                    status = H5Pset_fletcher32(filter_id);
+                    break;
+            }
+            if(status < 0)
+            {
+                H5Pclose(filter_id);
+                throw std::runtime_error(H5ZIO::filter_names[static_cast<int>(step.first)] + " filter is not available");
+            }
+        }
+        return filter_id;
+    }
+    
+    H5Pclose(filter_id);
+    return H5P_DEFAULT;
+}
+
+H5Zio::H5Zio():is_open(false), file_id(-1)
+{
+    total_input_data_size = 0;
+    total_storage_size = 0;
+    verbose_level = 1;
+    num_threads = 1;
+    filter_timing = false;
+    buffers = std::make_shared<H5ZioBufferPool>();
+    H5ZIO::register_intpack();
+}
+
+H5Zio::~H5Zio()
+{
+    if(is_open)
+    {
+        close();
+    }
+    set_filter_timing(false);
+
+    // Imprimir total de dados armazenados em Mb e taxa de compressão
+    if(verbose_level>0 && total_storage_size > 0)
+    {
+        std::cout <<"===============================================" << std::endl;
+        std::cout << "File name: " << file_name << std::endl;
+        std::cout << "Total input data size (in MB): " << total_input_data_size/1.0E6 << std::endl;
+        std::cout << "Total storage size (in MB): "    << total_storage_size/1.0E6 << std::endl;
+        std::cout << "Compression ratio: "    << (double) total_input_data_size / total_storage_size << std::endl;
+        std::cout <<"===============================================" << std::endl;
+    }
+
+}
+
+void H5Zio::set_filter_timing(bool enable)
+{
+    if(enable == filter_timing)
+    {
+        return;
+    }
+    filter_timing = enable;
+    if(enable)
+    {
+        H5ZioFilterTimer::enable();
+    }
+    else
+    {
+        H5ZioFilterTimer::disable();
+    }
+}
+
+void H5Zio::open(const std::string &filename, std::string fmode)
+{
+    H5ZIO_TRACE("H5Zio::open");
+    if(is_open)
+    {
+        close();
+    }
+
+    file_name = filename;
+
+    if(fmode == "a")
+    {
+        file_id = H5Fopen(filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+        mode    = H5ZIO::FileMode::APPEND;
+    }
+    else if(fmode == "w")
+    {
+        file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        mode    = H5ZIO::FileMode::WRITE;
+    }
+    else if(fmode == "r")
+    {
+        file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        mode    = H5ZIO::FileMode::READ;
+
+    }
+    else
+    {
+        throw std::runtime_error("Invalid mode");
+    }
+    if(this->verbose_level > 1)
+    {
+        std::cout << "File " << filename << " opened" << std::endl;
+        std::cout << "Mode: " << mode << std::endl;
+        std::cout << "File ID: " << file_id << std::endl;
+    }
+    is_open = true;
+}
+
+
+
+void H5Zio::open_memory(const std::string &filename, bool backing_store)
+{
+    if(is_open)
+    {
+        close();
+    }
+
+    file_name = filename;
+
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl, H5ZIO::CORE_INCREMENT, backing_store);
+    file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    H5Pclose(fapl);
+    if(file_id < 0)
+    {
+        throw std::runtime_error("Failed to create in-memory file");
+    }
+    mode = H5ZIO::FileMode::WRITE;
+
+    if(this->verbose_level > 1)
+    {
+        std::cout << "File " << filename << " opened in memory" << std::endl;
+        std::cout << "File ID: " << file_id << std::endl;
+    }
+    is_open = true;
+}
+
+void H5Zio::open_image(const void* buffer, size_t size)
+{
+    if(is_open)
+    {
+        close();
+    }
+
+    // nome único: o HDF5 identifica arquivos do driver core pelo nome
+    static std::atomic<unsigned int> images(0);
+    file_name = "image_" + std::to_string(images++);
+
+    // a imagem é copiada para o driver core; nada é gravado em disco
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl, H5ZIO::CORE_INCREMENT, false);
+    H5Pset_file_image(fapl, const_cast<void*>(buffer), size);
+    file_id = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+    H5Pclose(fapl);
+    if(file_id < 0)
+    {
+        throw std::runtime_error("Failed to open file image");
+    }
+    mode = H5ZIO::FileMode::READ;
+
+    if(this->verbose_level > 1)
+    {
+        std::cout << "File image opened (" << size << " bytes)" << std::endl;
+        std::cout << "File ID: " << file_id << std::endl;
+    }
+    is_open = true;
+}
+
+std::vector<unsigned char> H5Zio::get_image()
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    if(mode != H5ZIO::FileMode::READ)
+    {
+        H5Fflush(file_id, H5F_SCOPE_LOCAL);
+    }
+    ssize_t size = H5Fget_file_image(file_id, NULL, 0);
+    if(size < 0)
+    {
+        throw std::runtime_error("Failed to get file image");
+    }
+    std::vector<unsigned char> image(size);
+    if(H5Fget_file_image(file_id, image.data(), image.size()) != size)
+    {
+        throw std::runtime_error("Failed to get file image");
+    }
+    return image;
+}
+
+void H5Zio::flush()
+{
+    H5ZIO_TRACE("H5Zio::flush");
+    // a thread de I/O executa as tarefas em ordem: uma tarefa vazia marca o fim das pendentes
+    if(io_worker)
+    {
+        io_worker->submit([]() {}).get();
+    }
+    if(is_open && mode != H5ZIO::FileMode::READ)
+    {
+        H5Fflush(file_id, H5F_SCOPE_LOCAL);
+    }
+}
+
+void H5Zio::close()
+{
+    H5ZIO_TRACE("H5Zio::close");
+    // escritas pendentes terminam antes do fechamento
+    if(io_worker)
+    {
+        io_worker->submit([]() {}).get();
+    }
+
+    // listas de propriedades em cache pertencem a esta instância
+    for(auto& cached : filter_cache)
+    {
+        H5Pclose(cached.second);
+    }
+    filter_cache.clear();
+
+    {
+        H5ZIO_TRACE("H5Fclose");
+        H5Fclose(file_id);
+    }
+    is_open = false;
+}
+
+H5Dimensions H5Zio::dataset_dimensions(std::string dataset)
+{
+    // vefificar se o arquivo foi aberto em modo de leitura
+    if(mode != H5ZIO::FileMode::READ)
+    {
+        throw std::runtime_error("File not opened in read mode");
+    }
+
+    // abrir dataset
+    hid_t dset = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    if(dset < 0)
+    {
+        throw std::runtime_error("Dataset not found");
+    }
+
+    H5Dimensions dims = dataset_dimensions(dset);
+    H5Dclose(dset);
+    
+    return dims;
+}
+
+H5Dimensions H5Zio::dataset_dimensions(hid_t dataset_id)
+{
+    H5Dimensions dims;
+    hid_t space = H5Dget_space(dataset_id);
+    int ndims = H5Sget_simple_extent_ndims(space);
+    dims.set_ndims(ndims);
+    H5Sget_simple_extent_dims(space, dims.get_dims(), NULL);
+    H5Sclose(space);
+    return dims;
+}
+
+hid_t H5Zio::open_dataset(std::string dataset)
+{
+    hid_t dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    if(dataset_id < 0)
+    {
+        throw std::runtime_error("Failed to open dataset");
+    }
+    return dataset_id;
+}
+
+void* H5Zio::map_dataset(hid_t dataset_id, hid_t mem_type, size_t bytes, void*& base, size_t& length)
+{
+    // o conteúdo do arquivo não pode mudar enquanto estiver mapeado
+    if(mode != H5ZIO::FileMode::READ || bytes == 0)
+    {
+        return nullptr;
+    }
+
+    // somente o driver sec2 grava os dados diretamente no arquivo, sem userblock
+    hid_t   fapl     = H5Fget_access_plist(file_id);
+    hid_t   driver   = H5Pget_driver(fapl);
+    H5Pclose(fapl);
+    hid_t   fcpl     = H5Fget_create_plist(file_id);
+    hsize_t userblock = 0;
+    H5Pget_userblock(fcpl, &userblock);
+    H5Pclose(fcpl);
+    if(driver != H5FD_SEC2 || userblock != 0)
+    {
+        return nullptr;
+    }
+
+    // dataset contíguo, sem filtros e sem conversão de tipos
+    hid_t dcpl    = H5Dget_create_plist(dataset_id);
+    bool  mapable = H5Pget_layout(dcpl) == H5D_CONTIGUOUS && H5Pget_nfilters(dcpl) == 0;
+    H5Pclose(dcpl);
+    hid_t file_type = H5Dget_type(dataset_id);
+    mapable = mapable && H5Tequal(file_type, mem_type) > 0;
+    H5Tclose(file_type);
+    if(!mapable)
+    {
+        return nullptr;
+    }
+
+    // HADDR_UNDEF: espaço ainda não alocado
+    haddr_t offset = H5Dget_offset(dataset_id);
+    if(offset == HADDR_UNDEF || H5Dget_storage_size(dataset_id) < bytes)
+    {
+        return nullptr;
+    }
+    return H5ZIO::map_file(file_name, offset, bytes, base, length);
+}
+
+static std::string dataset_name(hid_t dataset_id)
+{
+    ssize_t length = H5Iget_name(dataset_id, NULL, 0);
+    if(length <= 0)
+    {
+        return std::string();
+    }
+    std::vector<char> name(length + 1);
+    H5Iget_name(dataset_id, name.data(), name.size());
+    return std::string(name.data());
+}
+
+void H5Zio::read_dataset(hid_t dataset_id, hid_t mem_type, void* data)
+{
+    H5ZIO_TRACE("H5Zio::read_dataset");
+    H5ZioDatasetStats record;
+    H5ZioTimer        wall, timer;
+    hid_t space = H5Dget_space(dataset_id);
+    record.calls        = 1;
+    record.raw_bytes    = H5Sget_simple_extent_npoints(space) * H5Tget_size(mem_type);
+    record.stored_bytes = H5Dget_storage_size(dataset_id);
+    H5Sclose(space);
+    H5ZioFilterScope filters(filter_record(dataset_id, record));
+    record.metadata_seconds = timer.lap();
+
+    // caminho paralelo: chunks lidos diretamente e decodificados fora do HDF5
+    if(num_threads < 2 || !read_chunks(dataset_id, mem_type, data, nullptr, nullptr, &record))
+    {
+        H5ZIO_TRACE("H5Dread");
+        H5Dread(dataset_id, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+        record.io_seconds += timer.lap();
+    }
+    record.wall_seconds = wall.lap();
+    add_stats(dataset_name(dataset_id), "read", record);
+}
+
+H5ZioDatasetStats* H5Zio::filter_record(hid_t dataset_id, H5ZioDatasetStats& record)
+{
+    if(!filter_timing)
+    {
+        return nullptr;
+    }
+    // somente os filtros do h5zio; os demais são medidos no caminho de chunks diretos
+    H5ZioFilterTimer::install(dataset_id);
+    return &record;
+}
+
+void H5Zio::add_stats(const std::string& dataset, const std::string& operation, H5ZioDatasetStats& record)
+{
+    // caminho absoluto: o mesmo registro para "u" e "/u"
+    record.dataset   = (dataset.empty() || dataset[0] != '/') ? "/" + dataset : dataset;
+    record.operation = operation;
+    stats.add(record);
+}
+
+void H5Zio::write_attributes(hid_t dataset_id, H5ZioAttribute* attributes)
+{
+    if(attributes == nullptr)
+    {
+        return;
+    }
+    H5ZIO_TRACE("write_attributes");
+    for(int i = 0; i < attributes->size(); i++)
+    {
+        auto attribute = attributes->get_attribute(i);
+        hid_t attribute_id   = H5Screate(H5S_SCALAR);
+        hid_t attribute_type = H5Tcopy(H5T_C_S1);
+        H5Tset_size(attribute_type, attribute.second.size());
+        hid_t att_id = H5Acreate2(dataset_id, attribute.first.c_str(), attribute_type, attribute_id, H5P_DEFAULT, H5P_DEFAULT);
+        H5Awrite(att_id, attribute_type, attribute.second.c_str());
+        H5Aclose(att_id);
+        H5Tclose(attribute_type);
+        H5Sclose(attribute_id);
+    }
+}
+
+void H5Zio::write_attributes(std::string dataset, H5ZioAttribute* attributes)
+{
+    if(!is_open)
+    {
+        throw std::runtime_error("File is not open");
+    }
+    hid_t dataset_id = open_dataset(dataset);
+    write_attributes(dataset_id, attributes);
+    H5Dclose(dataset_id);
+}
+
+void H5Zio::write_verify_summary(hid_t dataset_id, H5ZioVerifySummary& summary)
+{
+    if(summary.chunks == 0)
+    {
+        return;
+    }
+    auto number = [](double value) {
+        std::ostringstream ss;
+        ss.precision(10);
+        ss << value;
+        return ss.str();
+    };
+    H5ZioAttribute attributes;
+    attributes.create_attribute("h5zio_verified_chunks", std::to_string(summary.chunks));
+    attributes.create_attribute("h5zio_lossless_chunks", std::to_string(summary.lossless));
+    attributes.create_attribute("h5zio_max_abs_error",   number(summary.metrics.get_max_abs_error()));
+    attributes.create_attribute("h5zio_max_rel_error",   number(summary.metrics.get_max_rel_error()));
+    attributes.create_attribute("h5zio_rmse",            number(summary.metrics.get_rmse()));
+    attributes.create_attribute("h5zio_psnr",            number(summary.metrics.get_psnr()));
+    write_attributes(dataset_id, &attributes);
+
+    if(verbose_level > 0 && summary.lossless > 0)
+    {
+        std::cout << "Verification: " << summary.lossless << " of " << summary.chunks 
+                  << " chunks violated the error bound and were stored losslessly" << std::endl;
+    }
+}
+
+hid_t H5Zio::open_new_dataset(std::string dataset, hid_t type, hsize_t type_size, hsize_t ndims, const hsize_t dims[], 
+                              H5ZIOParameters* parameters)
+{
+    hid_t   filter_id = H5P_DEFAULT;
+    hsize_t h5dims[ndims];
+    std::copy(dims, dims + ndims, h5dims);
+
+    if(parameters != nullptr)
+    {
+        filter_id = create_filter(parameters, type, ndims, h5dims, type_size);
+    }
+
+    hid_t dataspace_id = H5Screate_simple(ndims, h5dims, NULL);
+    if(dataspace_id < 0)
+    {
+        throw std::runtime_error("Failed to create dataspace");
+    }
+
+    // filter_id pertence ao cache de create_filter
+    hid_t dataset_id;
+    {
+        H5ZIO_TRACE("H5Dcreate2");
+        dataset_id = H5Dcreate2(file_id, dataset.c_str(), type, dataspace_id, H5P_DEFAULT, filter_id, H5P_DEFAULT);
+    }
+    H5Sclose(dataspace_id);
+    if(dataset_id < 0)
+    {
+        throw std::runtime_error("Failed to create dataset");
+    }
+    return dataset_id;
+}
+
+void H5Zio::write_region(hid_t dataset_id, hid_t type, hsize_t type_size, const hsize_t offset[], const hsize_t count[], const void* data,
+                         H5ZioDatasetStats* record)
+{
+    // sem registro de quem chama, a escrita é registrada como uma operação do dataset
+    H5ZioDatasetStats local;
+    H5ZioDatasetStats& stats_record = record != nullptr ? *record : local;
+    H5ZioFilterScope   filters(filter_record(dataset_id, stats_record));
+    H5ZioTimer wall, timer;
+
+    hid_t space = H5Dget_space(dataset_id);
+    int   ndims = H5Sget_simple_extent_ndims(space);
+    std::vector<hsize_t> dims(ndims);
+    H5Sget_simple_extent_dims(space, dims.data(), NULL);
+    for(int i = 0; i < ndims; i++)
+    {
+        if(count[i] == 0 || offset[i] + count[i] > dims[i])
+        {
+            H5Sclose(space);
+            throw std::runtime_error("Region is out of the dataset bounds");
+        }
+    }
+
+    hsize_t before = H5Dget_storage_size(dataset_id);
+
+    // regiões alinhadas aos chunks são codificadas em paralelo e gravadas diretamente
+    hid_t file_type = H5Dget_type(dataset_id);
+    bool  direct = num_threads > 1 && H5Tequal(file_type, type) > 0;
+    H5Tclose(file_type);
+
+    herr_t status = 0;
+    stats_record.metadata_seconds += timer.lap();
+    if(!direct || !write_chunks(dataset_id, data, ndims, count, offset, nullptr, nullptr, &stats_record))
+    {
+        hid_t mem_space = H5Screate_simple(ndims, count, NULL);
+        H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, NULL, count, NULL);
+        {
+            H5ZIO_TRACE("H5Dwrite");
+            status = H5Dwrite(dataset_id, type, mem_space, space, H5P_DEFAULT, data);
+        }
+        H5Sclose(mem_space);
+        stats_record.io_seconds += timer.lap();
+    }
+    H5Sclose(space);
+    if(status < 0)
+    {
+        throw std::runtime_error("Failed to write region");
+    }
+
+    hsize_t stored = H5Dget_storage_size(dataset_id) - before;
+    total_input_data_size += compute_size(ndims, count) * type_size;
+    total_storage_size    += stored;
+    stats_record.raw_bytes    += compute_size(ndims, count) * type_size;
+    stats_record.stored_bytes += stored;
+    if(record == nullptr)
+    {
+        local.calls            = 1;
+        local.metadata_seconds += timer.lap();
+        local.wall_seconds     = wall.lap();
+        add_stats(dataset_name(dataset_id), "write", local);
+    }
+}
+
+void H5Zio::create_extendible(std::string dataset, hid_t type, hsize_t type_size, hsize_t ndims, const hsize_t dims[], 
+                              H5ZIOParameters* parameters, H5ZioAttribute* attributes)
+{
+    // eixo do tempo ilimitado na primeira dimensão
+    hsize_t rank = ndims + 1;
+    hsize_t current[rank], maximum[rank], chunk[rank];
+    current[0] = 0;
+    maximum[0] = H5S_UNLIMITED;
+    for(int i = 0; i < ndims; i++)
+    {
+        current[i+1] = dims[i];
+        maximum[i+1] = dims[i];
+    }
+
+    // um passo de tempo por chunk: novos passos nunca reescrevem chunks anteriores
+    H5ZIOParameters uncompressed;
+    uncompressed.set_compression_type(H5ZIO::Type::NONE);
+    H5ZIOParameters* planner = (parameters != nullptr) ? parameters : &uncompressed;
+    chunk[0] = 1;
+    planner->plan_chunk_dimensions(ndims, dims, type_size, chunk + 1);
+
+    // listas de create_filter pertencem ao cache e não são fechadas aqui
+    hid_t dcpl = H5P_DEFAULT;
+    bool  cached = parameters != nullptr && parameters->get_compression_type() != H5ZIO::Type::NONE;
+    if(cached)
+    {
+        dcpl = create_filter(parameters, type, rank, maximum, type_size, chunk);
+    }
+    else
+    {
+        dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(dcpl, rank, chunk);
+    }
+
+    hid_t dataspace_id = H5Screate_simple(rank, current, maximum);
+    hid_t dataset_id;
+    {
+        H5ZIO_TRACE("H5Dcreate2");
+        dataset_id = H5Dcreate2(file_id, dataset.c_str(), type, dataspace_id, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    }
+    if(!cached)
+    {
+        H5Pclose(dcpl);
+    }
+    H5Sclose(dataspace_id);
+    if(dataset_id < 0)
+    {
+        throw std::runtime_error("Failed to create dataset");
+    }
+    write_attributes(dataset_id, attributes);
+    H5Dclose(dataset_id);
+}
+
+void H5Zio::append_step(std::string dataset, hid_t type, hsize_t type_size, const void* data, hsize_t nelements)
+{
+    H5ZIO_TRACE("H5Zio::append");
+    hid_t dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    if(dataset_id < 0)
+    {
+        throw std::runtime_error("Failed to open dataset");
+    }
+
+    hid_t space = H5Dget_space(dataset_id);
+    int   rank  = H5Sget_simple_extent_ndims(space);
+    std::vector<hsize_t> dims(rank), maximum(rank);
+    H5Sget_simple_extent_dims(space, dims.data(), maximum.data());
+    H5Sclose(space);
+    if(rank < 2 || maximum[0] != H5S_UNLIMITED)
+    {
+        H5Dclose(dataset_id);
+        throw std::runtime_error("Dataset is not a time series");
+    }
+
+    std::vector<hsize_t> step_dims(dims.begin() + 1, dims.end());
+    if(nelements > 0 && nelements != compute_size(step_dims))
+    {
+        H5Dclose(dataset_id);
+        throw std::runtime_error("Data size does not match the time step dimensions");
+    }
+
+    hsize_t step = dims[0];
+    dims[0] = step + 1;
+    if(H5Dset_extent(dataset_id, dims.data()) < 0)
+    {
+        H5Dclose(dataset_id);
+        throw std::runtime_error("Failed to extend dataset");
+    }
+
+    // região do novo passo de tempo
+    std::vector<hsize_t> start(rank, 0), count(dims);
+    start[0] = step;
+    count[0] = 1;
+
+    try
+    {
+        write_region(dataset_id, type, type_size, start.data(), count.data(), data);
+    }
+    catch(...)
+    {
+        H5Dclose(dataset_id);
+        throw;
+    }
+    H5Dclose(dataset_id);
+}
+
+typedef std::vector<unsigned char> chunk_buffer;
+
+// Chunk codificado e, com verificação, o erro dos dados gravados
+struct encoded_chunk
+{
+    encoded_chunk() : filter_mask(0), verified(false), seconds(0.0), encode_seconds(0.0) {}
+    chunk_buffer bytes;
+    uint32_t     filter_mask;   // filtros desativados no chunk gravado
+    bool         verified;
+    H5ZioMetrics metrics;
+    double       seconds;        // tempo de codificação e verificação
+    double       encode_seconds; // tempo dos filtros (H5ZioChunkCodec::encode)
+};
+
+// folga relativa no limite de erro para arredondamentos na reconstrução
+static const double VERIFY_TOLERANCE = 1e-6;
+
+// Acumula o erro da região válida de um chunk, linha a linha (a borda é ignorada)
+template <typename T>
+static void compare_chunk(const void* original, const void* decoded, hsize_t ndims, const hsize_t chunk_dims[], 
+                          const hsize_t count[], H5ZioMetrics& metrics)
+{
+    const T* a = static_cast<const T*>(original);
+    const T* b = static_cast<const T*>(decoded);
+    hsize_t  rows = compute_size(ndims - 1, count);
+    std::vector<hsize_t> idx(ndims, 0);
+    for(hsize_t r = 0; r < rows; r++)
+    {
+        hsize_t pos = 0;
+        for(int i = 0; i < ndims; i++)
+        {
+            pos = pos * chunk_dims[i] + idx[i];
+        }
+        metrics.update(a + pos, b + pos, count[ndims-1]);
+        for(int i = ndims - 2; i >= 0; i--)
+        {
+            if(++idx[i] < count[i]) break;
+            idx[i] = 0;
+        }
+    }
+}
+
+// Tipos que os compressores com perdas aceitam (float, double, int32 e int64)
+static bool verifiable_type(hid_t type)
+{
+    H5T_class_t type_class = H5Tget_class(type);
+    size_t      size       = H5Tget_size(type);
+    return (type_class == H5T_FLOAT || type_class == H5T_INTEGER) && (size == 4 || size == 8);
+}
+
+static void compare_chunk(hid_t type, const void* original, const void* decoded, hsize_t ndims, const hsize_t chunk_dims[], 
+                          const hsize_t count[], H5ZioMetrics& metrics)
+{
+    bool floating = H5Tget_class(type) == H5T_FLOAT;
+    if(H5Tget_size(type) == 4)
+    {
+        if(floating) compare_chunk<float>(original, decoded, ndims, chunk_dims, count, metrics);
+        else         compare_chunk<int32_t>(original, decoded, ndims, chunk_dims, count, metrics);
+    }
+    else
+    {
+        if(floating) compare_chunk<double>(original, decoded, ndims, chunk_dims, count, metrics);
+        else         compare_chunk<int64_t>(original, decoded, ndims, chunk_dims, count, metrics);
+    }
+}
+
+// Verifica o limite de erro dos parâmetros em um chunk. Limites relativos usam
+// range, a amplitude do chunk completo que o filtro comprimiu (com os zeros 
+// da borda). Compressores sem perdas devem reconstruir os dados exatamente
+static bool within_bound(H5ZIOParameters& parameters, const H5ZioMetrics& metrics, double range)
+{
+    const double slack = 1.0 + VERIFY_TOLERANCE;
+    double error = metrics.get_max_abs_error();
+
+    if(parameters.get_compression_type() == H5ZIO::Type::ZFP && 
+       parameters.get_error_bound_type() == static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY))
+    {
+        return error <= parameters.get_error_bound_value(H5ZIO::ZFP::ErrorBound::ACCURACY) * slack;
+    }
+    if(parameters.get_compression_type() != H5ZIO::Type::SZ2)
+    {
+        return error == 0.0;
+    }
+
+    double absolute = parameters.get_error_bound_value(H5ZIO::SZ2::ErrorBound::ABSOLUTE);
+    double relative = parameters.get_error_bound_value(H5ZIO::SZ2::ErrorBound::RELATIVE) * range;
+    switch(static_cast<H5ZIO::SZ2::ErrorBound>(parameters.get_error_bound_type()))
+    {
+        case H5ZIO::SZ2::ErrorBound::ABSOLUTE:
+            return error <= absolute * slack;
+        case H5ZIO::SZ2::ErrorBound::RELATIVE:
+            return error <= relative * slack;
+        case H5ZIO::SZ2::ErrorBound::ABS_AND_REL:
+            return error <= std::min(absolute, relative) * slack;
+        case H5ZIO::SZ2::ErrorBound::ABS_OR_REL:
+            return error <= std::max(absolute, relative) * slack;
+        case H5ZIO::SZ2::ErrorBound::SZ_PSNR:
+        {
+            double rmse = metrics.get_rmse();
+            double psnr = rmse > 0 ? 20.0 * std::log10(range / rmse) : std::numeric_limits<double>::infinity();
+            return psnr * slack >= parameters.get_error_bound_value(H5ZIO::SZ2::ErrorBound::SZ_PSNR);
+        }
+        case H5ZIO::SZ2::ErrorBound::PW_RELATIVE:
+            return metrics.get_max_rel_error() <= parameters.get_error_bound_value(H5ZIO::SZ2::ErrorBound::PW_RELATIVE) * slack;
+    }
+    return false;
+}
+
+// Amplitude do chunk completo, com os zeros da borda, que o compressor recebeu
+static double chunk_range(hid_t type, const void* raw, hsize_t ndims, const hsize_t chunk_dims[], const hsize_t count[], 
+                          const H5ZioMetrics& metrics)
+{
+    if(std::equal(count, count + ndims, chunk_dims))
+    {
+        return metrics.get_range();
+    }
+    H5ZioMetrics padded;
+    compare_chunk(type, raw, raw, ndims, chunk_dims, chunk_dims, padded);
+    return padded.get_range();
+}
+
+// Copia um chunk de um array para um buffer completo e o codifica.
+// Chunks da borda são completados com zeros, como no pipeline do HDF5.
+// Com verificação, o chunk codificado é decodificado e, se violar o limite
+// de erro, é substituído pelos dados originais com o filtro desativado.
+// Os buffers de trabalho e o chunk codificado são contabilizados em memory;
+// o chunk codificado é descontado ao ser gravado (write_encoded_chunk)
+static encoded_chunk encode_chunk(H5ZioChunkCodec& codec, const void* data, hsize_t ndims, const hsize_t data_dims[], 
+                                  const hsize_t start[], const hsize_t count[], H5ZioMemoryTracker& memory, 
+                                  H5ZIOParameters* verify = nullptr)
+{
+    H5ZioTimer timer;
+    size_t     work_bytes = codec.get_chunk_bytes() * (verify != nullptr ? 2 : 1);
+    memory.acquire(work_bytes);
+
+    std::vector<hsize_t> origin(ndims, 0);
+    chunk_buffer raw(codec.get_chunk_bytes(), 0);
+    H5ZIO::copy_box(ndims, codec.get_element_size(), count, data, data_dims, start, 
+                    raw.data(), codec.get_chunk_dims(), origin.data());
+    encoded_chunk out;
+    {
+        H5ZIO_TRACE("encode_chunk");
+        H5ZioTimer encode_timer;
+        codec.encode(raw.data(), out.bytes);
+        out.encode_seconds = encode_timer.lap();
+    }
+    // filtro opcional sem ganho: o chunk é gravado sem ele, como no pipeline do HDF5
+    if(codec.is_optional() && out.bytes.size() >= raw.size())
+    {
+        out.bytes.swap(raw);
+        out.filter_mask = codec.get_raw_mask();
+    }
+
+    if(verify != nullptr && out.filter_mask == 0)
+    {
+        H5ZIO_TRACE("verify_chunk");
+        chunk_buffer decoded(codec.get_chunk_bytes());
+        codec.decode(out.bytes.data(), out.bytes.size(), decoded.data());
+        compare_chunk(codec.get_type(), raw.data(), decoded.data(), ndims, codec.get_chunk_dims(), count, out.metrics);
+        out.verified = true;
+        double range = chunk_range(codec.get_type(), raw.data(), ndims, codec.get_chunk_dims(), count, out.metrics);
+        if(!within_bound(*verify, out.metrics, range))
+        {
+            out.metrics.reset();
+            compare_chunk(codec.get_type(), raw.data(), raw.data(), ndims, codec.get_chunk_dims(), count, out.metrics);
+            out.bytes.swap(raw);
+            out.filter_mask = codec.get_raw_mask();
+        }
+    }
+
+    memory.acquire(out.bytes.size());
+    memory.release(work_bytes);
+    out.seconds = timer.lap();
+    return out;
+}
+
+// Grava um chunk codificado e acumula o resultado da verificação e as estatísticas
+static void write_encoded_chunk(hid_t dataset_id, const hsize_t offset[], size_t chunk_bytes, encoded_chunk& chunk, 
+                                H5ZioVerifySummary* summary, H5ZioDatasetStats* record, H5ZioMemoryTracker& memory)
+{
+    H5ZIO_TRACE("H5Dwrite_chunk");
+    H5ZioTimer timer;
+    if(H5Dwrite_chunk(dataset_id, H5P_DEFAULT, chunk.filter_mask, offset, chunk.bytes.size(), chunk.bytes.data()) < 0)
+    {
+        throw std::runtime_error("Failed to write chunk");
+    }
+    memory.release(chunk.bytes.size());
+    // filtros codificados fora do HDF5: medidos aqui com set_filter_timing
+    if(H5ZioDatasetStats* filters = H5ZioFilterTimer::current())
+    {
+        H5ZioFilterTimer::add_chunk(filters, chunk_bytes, chunk.bytes.size(), chunk.encode_seconds);
+    }
+    if(chunk.verified && summary != nullptr)
+    {
+        summary->chunks++;
+        summary->lossless += chunk.filter_mask != 0;
+        summary->metrics.merge(chunk.metrics);
+    }
+    if(record != nullptr)
+    {
+        record->io_seconds          += timer.lap();
+        record->compression_seconds += chunk.seconds;
+    }
+}
+
+// Planeja blocos formados por chunks inteiros do dataset de saída, crescendo a 
+// partir da última dimensão (contígua) enquanto couberem no limite de memória
+static void plan_block_dimensions(hsize_t ndims, const hsize_t dims[], const hsize_t chunk[], hsize_t type_size, hsize_t budget, hsize_t block[])
+{
+    hsize_t bytes = type_size;
+    for(int i = 0; i < ndims; i++)
+    {
+        block[i] = std::min(chunk[i], dims[i]);
+        bytes  *= block[i];
+    }
+    for(int i = ndims - 1; i >= 0; i--)
+    {
+        hsize_t nchunks = (dims[i] + chunk[i] - 1) / chunk[i];
+        hsize_t factor  = std::min(nchunks, std::max<hsize_t>(1, budget / bytes));
+        block[i]  = std::min(dims[i], block[i] * factor);
+        bytes   *= factor;
+        if(factor < nchunks) break;
+    }
+}
+
+void H5Zio::copy_blocks(H5Zio& input, std::string dataset, hid_t type, hsize_t type_size, hsize_t memory_budget, 
+                        H5ZIOParameters* verify, H5ZioDatasetStats& record)
+{
+    H5ZIO_TRACE("H5Zio::copy_dataset");
+    hid_t in_id  = H5Dopen(input.file_id, dataset.c_str(), H5P_DEFAULT);
+    hid_t out_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    if(in_id < 0 || out_id < 0)
+    {
+        if(in_id >= 0)  H5Dclose(in_id);
+        if(out_id >= 0) H5Dclose(out_id);
+        throw std::runtime_error("Failed to open dataset");
+    }
+
+    hid_t space = H5Dget_space(out_id);
+    int   ndims = H5Sget_simple_extent_ndims(space);
+    std::vector<hsize_t> dims(ndims);
+    H5Sget_simple_extent_dims(space, dims.data(), NULL);
+    H5Sclose(space);
+
+    // blocos alinhados aos chunks: cada chunk comprimido é gravado uma única vez.
+    // Com saída contígua, alinhados aos chunks da entrada: cada chunk é decodificado uma única vez
+    std::vector<hsize_t> chunk(ndims, 1);
+    hid_t dcpl = H5Dget_create_plist(out_id);
+    if(H5Pget_layout(dcpl) != H5D_CHUNKED)
+    {
+        H5Pclose(dcpl);
+        dcpl = H5Dget_create_plist(in_id);
+    }
+    if(H5Pget_layout(dcpl) == H5D_CHUNKED)
+    {
+        H5Pget_chunk(dcpl, ndims, chunk.data());
+    }
+    H5Pclose(dcpl);
+
+    H5ZioChunkCodec codec(out_id);
+    hid_t file_type = H5Dget_type(out_id);
+    // a verificação decodifica os chunks no pool, mesmo com uma única thread
+    bool  pipeline  = (num_threads > 1 || verify != nullptr) && codec.is_supported() && codec.get_ndims() == ndims && 
+                      H5Tequal(file_type, type) > 0;
+    if(verify != nullptr && !verifiable_type(file_type))
+    {
+        if(verbose_level > 0)
+        {
+            std::cout << "Verification: skipped, the element type is not supported" << std::endl;
+        }
+        verify = nullptr;
+    }
+    H5Tclose(file_type);
+    H5ZioVerifySummary summary;
+    H5ZioMemoryTracker memory;
+    H5ZioTimer         timer;
+    hsize_t            before = H5Dget_storage_size(out_id);
+
+    // no pipeline até três blocos coexistem: o lido, o codificado e o gravado
+    hsize_t block_budget = pipeline ? memory_budget / 3 : memory_budget;
+    std::vector<hsize_t> block(ndims);
+    plan_block_dimensions(ndims, dims.data(), chunk.data(), type_size, block_budget, block.data());
+    H5ZioChunkGrid blocks(ndims, dims.data(), block.data());
+    hsize_t block_size = compute_size(block) * type_size;
+
+    try
+    {
+        if(!pipeline)
+        {
+            // um único buffer reutilizado, sem inicialização
+            std::unique_ptr<unsigned char[]> buffer(new unsigned char[block_size]);
+            memory.acquire(block_size);
+            std::vector<hsize_t> offset(ndims), count(ndims);
+            for(hsize_t b = 0; b < blocks.size(); b++)
+            {
+                blocks.chunk(b, offset.data(), count.data());
+                timer.lap();
+                input.read_region(in_id, type, offset.data(), count.data(), nullptr, buffer.get());
+                record.io_seconds += timer.lap();
+                write_region(out_id, type, type_size, offset.data(), count.data(), buffer.get(), &record);
+                // filtros sem codificação direta: o bloco gravado é lido de volta
+                if(verify != nullptr)
+                {
+                    timer.lap();
+                    verify_chunks(out_id, type, buffer.get(), ndims, count.data(), offset.data(), *verify, summary);
+                    record.compression_seconds += timer.lap();
+                }
+            }
+            if(verify != nullptr)
+            {
+                write_verify_summary(out_id, summary);
+                record.metadata_seconds += timer.lap();
+            }
+        }
+        else
+        {
+            // Pipeline: enquanto o pool codifica os chunks do bloco b, esta thread
+            // lê o bloco b+1 e grava os chunks já codificados do bloco b-1.
+            // Todas as chamadas ao HDF5 ficam nesta thread de I/O
+            struct pending_block
+            {
+                std::vector<hsize_t> offset, count;
+                std::deque<std::pair<std::vector<hsize_t>, std::future<encoded_chunk> > > chunks;
+            };
+            std::deque<pending_block> in_flight;
+            H5ZioThreadPool& pool  = thread_pool();
+            H5ZioFilterScope filters(filter_record(out_id, record));
+
+            auto write_oldest = [&]() {
+                pending_block& oldest = in_flight.front();
+                while(!oldest.chunks.empty())
+                {
+                    encoded_chunk encoded = oldest.chunks.front().second.get();
+                    write_encoded_chunk(out_id, oldest.chunks.front().first.data(), codec.get_chunk_bytes(), encoded, &summary, &record, memory);
+                    oldest.chunks.pop_front();
+                }
+                total_input_data_size += compute_size(oldest.count) * type_size;
+                record.raw_bytes      += compute_size(oldest.count) * type_size;
+                memory.release(block_size);
+                in_flight.pop_front();
+            };
+
+            try
+            {
+                for(hsize_t b = 0; b < blocks.size(); b++)
+                {
+                    pending_block current;
+                    current.offset.resize(ndims);
+                    current.count.resize(ndims);
+                    blocks.chunk(b, current.offset.data(), current.count.data());
+
+                    // o bloco lido é compartilhado pelas tarefas que codificam seus chunks
+                    std::shared_ptr<unsigned char> raw(new unsigned char[block_size], std::default_delete<unsigned char[]>());
+                    memory.acquire(block_size);
+                    timer.lap();
+                    input.read_region(in_id, type, current.offset.data(), current.count.data(), nullptr, raw.get());
+                    record.io_seconds += timer.lap();
+
+                    H5ZioChunkGrid grid(ndims, dims.data(), chunk.data(), current.offset.data(), current.count.data());
+                    for(hsize_t c = 0; c < grid.size(); c++)
+                    {
+                        std::vector<hsize_t> offset(ndims), count(ndims), in_block(ndims);
+                        grid.chunk(c, offset.data(), count.data());
+                        for(int i = 0; i < ndims; i++)
+                        {
+                            in_block[i] = offset[i] - current.offset[i];
+                        }
+                        std::vector<hsize_t> block_dims(current.count);
+                        current.chunks.emplace_back(offset, pool.submit([&codec, &memory, raw, ndims, block_dims, in_block, count, verify]() {
+                            return encode_chunk(codec, raw.get(), ndims, block_dims.data(), in_block.data(), count.data(), memory, verify);
+                        }));
+                    }
+                    in_flight.push_back(std::move(current));
+
+                    while(in_flight.size() > 1)
+                    {
+                        write_oldest();
+                    }
+                }
+                while(!in_flight.empty())
+                {
+                    write_oldest();
+                }
+            }
+            catch(...)
+            {
+                // as tarefas pendentes referenciam o codec: aguarda antes de propagar o erro
+                for(auto& pending : in_flight)
+                {
+                    for(auto& c : pending.chunks)
+                    {
+                        c.second.wait();
+                    }
+                }
+                throw;
+            }
+            total_storage_size += H5Dget_storage_size(out_id) - before;
+            record.stored_bytes += H5Dget_storage_size(out_id) - before;
+            timer.lap();
+            write_verify_summary(out_id, summary);
+            record.metadata_seconds += timer.lap();
+        }
+    }
+    catch(...)
+    {
+        H5Dclose(in_id);
+        H5Dclose(out_id);
+        throw;
+    }
+    record.peak_buffer_bytes = std::max(record.peak_buffer_bytes, memory.get_peak());
+    H5Dclose(in_id);
+    H5Dclose(out_id);
+}
+
+H5ZioThreadPool& H5Zio::thread_pool()
+{
+    if(!workers || workers->size() != num_threads)
+    {
+        workers.reset(new H5ZioThreadPool(num_threads));
+    }
+    return *workers;
+}
+
+std::future<void> H5Zio::submit_io(std::function<void()> task)
+{
+    if(!io_worker)
+    {
+        io_worker.reset(new H5ZioThreadPool(1));
+    }
+    return io_worker->submit(task);
+}
+
+bool H5Zio::write_chunks(hid_t dataset_id, const void* data, hsize_t ndims, const hsize_t dims[], const hsize_t start[],
+                         H5ZIOParameters* verify, H5ZioVerifySummary* summary, H5ZioDatasetStats* record)
+{
+    H5ZIO_TRACE("write_chunks");
+    H5ZioChunkCodec codec(dataset_id);
+    if(!codec.is_supported() || codec.get_ndims() != ndims)
+    {
+        return false;
+    }
+    if(verify != nullptr && !verifiable_type(codec.get_type()))
+    {
+        if(verbose_level > 0)
+        {
+            std::cout << "Verification: skipped, the element type is not supported" << std::endl;
+        }
+        verify = nullptr;
+    }
+
+    // região gravada: o dataset inteiro se start não for informado
+    std::vector<hsize_t> dataset_dims(dims, dims + ndims), region_start(ndims, 0);
+    if(start != nullptr)
+    {
+        hid_t space = H5Dget_space(dataset_id);
+        H5Sget_simple_extent_dims(space, dataset_dims.data(), NULL);
+        H5Sclose(space);
+        region_start.assign(start, start + ndims);
+    }
+    // somente chunks inteiramente cobertos pela região podem ser gravados diretamente
+    const hsize_t* chunk_dims = codec.get_chunk_dims();
+    for(int i = 0; i < ndims; i++)
+    {
+        if(region_start[i] % chunk_dims[i] != 0 || 
+           (region_start[i] + dims[i] != dataset_dims[i] && dims[i] % chunk_dims[i] != 0))
+        {
+            return false;
+        }
+    }
+
+    H5ZioChunkGrid   grid(ndims, dataset_dims.data(), chunk_dims, region_start.data(), dims);
+    H5ZioThreadPool& pool = thread_pool();
+
+    // a compressão roda no pool; as chamadas ao HDF5 ficam nesta thread.
+    // No máximo 2 chunks por thread ficam em memória aguardando gravação
+    std::deque<std::pair<std::vector<hsize_t>, std::future<encoded_chunk> > > pending;
+    size_t window = 2 * pool.size();
+    H5ZioMemoryTracker memory;
+
+    try
+    {
+        for(hsize_t c = 0; c < grid.size(); c++)
+        {
+            std::vector<hsize_t> offset(ndims), count(ndims);
+            grid.chunk(c, offset.data(), count.data());
+            std::vector<hsize_t> in_region(ndims);
+            for(int i = 0; i < ndims; i++)
+            {
+                in_region[i] = offset[i] - region_start[i];
+            }
+            std::future<encoded_chunk> encoded = pool.submit([&codec, &memory, data, ndims, dims, in_region, count, verify]() {
+                return encode_chunk(codec, data, ndims, dims, in_region.data(), count.data(), memory, verify);
+            });
+            pending.emplace_back(offset, std::move(encoded));
+
+            while(pending.size() >= window || (c + 1 == grid.size() && !pending.empty()))
+            {
+                encoded_chunk chunk = pending.front().second.get();
+                write_encoded_chunk(dataset_id, pending.front().first.data(), codec.get_chunk_bytes(), chunk, summary, record, memory);
+                pending.pop_front();
+            }
+        }
     }
-    else if (params->get_compression_type() == H5ZIO::Type::GZIP)
+    catch(...)
     {
-        avail = H5Zfilter_avail(H5Z_FILTER_DEFLATE);
-        if(avail < 0)
+        // as tarefas pendentes referenciam o codec: aguarda antes de propagar o erro
+        for(auto& p : pending)
         {
-            throw std::runtime_error("GZIP filter is not available");
+            p.second.wait();
         }
-        H5Pset_chunk(filter_id, ndims, dims);
-        H5Pset_deflate(filter_id, params->get_gzip_level());
-        return filter_id;
+        throw;
     }
-    
-    return H5P_DEFAULT;
+    if(record != nullptr)
+    {
+        record->peak_buffer_bytes = std::max(record->peak_buffer_bytes, memory.get_peak());
+    }
+    return true;
 }
 
-H5Zio::H5Zio():is_open(false), file_id(-1)
+bool H5Zio::verify_chunks(hid_t dataset_id, hid_t type, const void* data, hsize_t ndims, const hsize_t dims[], const hsize_t start[],
+                          H5ZIOParameters& parameters, H5ZioVerifySummary& summary)
 {
-    total_input_data_size = 0;
-    total_storage_size = 0;
-    verbose_level = 1;
-}
+    H5ZIO_TRACE("verify_chunks");
+    hid_t dcpl = H5Dget_create_plist(dataset_id);
+    if(H5Pget_layout(dcpl) != H5D_CHUNKED || H5Pget_nfilters(dcpl) == 0)
+    {
+        // sem filtros os dados são gravados sem perdas
+        H5Pclose(dcpl);
+        return true;
+    }
+    int nfilters = H5Pget_nfilters(dcpl);
+    std::vector<hsize_t> chunk_dims(ndims);
+    H5Pget_chunk(dcpl, ndims, chunk_dims.data());
+
+    hid_t file_type = H5Dget_type(dataset_id);
+    bool  same_type = H5Tequal(file_type, type) > 0;
+    H5Tclose(file_type);
+    if(!same_type || !verifiable_type(type))
+    {
+        H5Pclose(dcpl);
+        if(verbose_level > 0)
+        {
+            std::cout << "Verification: skipped, the element type is not supported" << std::endl;
+        }
+        return false;
+    }
 
-H5Zio::~H5Zio()
-{
-    if(is_open)
+    // O cache de chunks do dataset guarda os dados antes dos filtros: cada chunk
+    // gravado é copiado para um dataset de um único chunk, com os mesmos filtros, 
+    // em um arquivo em memória, e decodificado pelo pipeline do HDF5
+    static std::atomic<unsigned int> scratch_files(0);
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl, H5ZIO::CORE_INCREMENT, false);
+    hid_t scratch_file = H5Fcreate(("h5zio_verify_" + std::to_string(scratch_files++) + ".h5").c_str(), 
+                                   H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    H5Pclose(fapl);
+    hid_t chunk_space = H5Screate_simple(ndims, chunk_dims.data(), NULL);
+    hid_t scratch     = scratch_file < 0 ? -1 : H5Dcreate2(scratch_file, "chunk", type, chunk_space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Sclose(chunk_space);
+    H5Pclose(dcpl);
+    if(scratch < 0)
     {
-        close();
+        if(scratch_file >= 0) H5Fclose(scratch_file);
+        throw std::runtime_error("Failed to create dataset for verification");
     }
 
-    // Imprimir total de dados armazenados em Mb e taxa de compressão
-    if(verbose_level>0 && total_storage_size > 0)
+    // região gravada: o dataset inteiro se start não for informado
+    std::vector<hsize_t> dataset_dims(dims, dims + ndims), region_start(ndims, 0);
+    if(start != nullptr)
     {
-        std::cout <<"===============================================" << std::endl;
-        std::cout << "File name: " << file_name << std::endl;
-        std::cout << "Total input data size (in MB): " << total_input_data_size/1.0E6 << std::endl;
-        std::cout << "Total storage size (in MB): "    << total_storage_size/1.0E6 << std::endl;
-        std::cout << "Compression ratio: "    << (double) total_input_data_size / total_storage_size << std::endl;
-        std::cout <<"===============================================" << std::endl;
+        hid_t space = H5Dget_space(dataset_id);
+        H5Sget_simple_extent_dims(space, dataset_dims.data(), NULL);
+        H5Sclose(space);
+        region_start.assign(start, start + ndims);
     }
 
+    size_t   elem_size = H5Tget_size(type);
+    uint32_t raw_mask  = (1u << nfilters) - 1;
+    H5ZioChunkGrid grid(ndims, dataset_dims.data(), chunk_dims.data(), region_start.data(), dims);
+    chunk_buffer   raw(compute_size(chunk_dims) * elem_size), decoded(raw.size()), stored;
+    std::vector<hsize_t> offset(ndims), count(ndims), in_region(ndims), origin(ndims, 0);
+    try
+    {
+        for(hsize_t c = 0; c < grid.size(); c++)
+        {
+            grid.chunk(c, offset.data(), count.data());
+            for(int i = 0; i < ndims; i++)
+            {
+                in_region[i] = offset[i] - region_start[i];
+            }
+            // dados originais com os zeros da borda, como o pipeline do HDF5 os recebeu
+            std::fill(raw.begin(), raw.end(), 0);
+            H5ZIO::copy_box(ndims, elem_size, count.data(), data, dims, in_region.data(), raw.data(), chunk_dims.data(), origin.data());
+
+            hsize_t  stored_size = 0;
+            uint32_t filter_mask = 0;
+            if(H5Dget_chunk_storage_size(dataset_id, offset.data(), &stored_size) < 0)
+            {
+                throw std::runtime_error("Failed to read chunk for verification");
+            }
+            stored.resize(stored_size);
+            if(H5Dread_chunk(dataset_id, H5P_DEFAULT, offset.data(), &filter_mask, stored.data()) < 0 ||
+               H5Dwrite_chunk(scratch, H5P_DEFAULT, filter_mask, origin.data(), stored.size(), stored.data()) < 0 ||
+               H5Dread(scratch, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, decoded.data()) < 0)
+            {
+                throw std::runtime_error("Failed to read chunk for verification");
+            }
+
+            H5ZioMetrics metrics;
+            compare_chunk(type, raw.data(), decoded.data(), ndims, chunk_dims.data(), count.data(), metrics);
+            if(!within_bound(parameters, metrics, chunk_range(type, raw.data(), ndims, chunk_dims.data(), count.data(), metrics)))
+            {
+                // chunk regravado com todos os filtros desativados
+                if(H5Dwrite_chunk(dataset_id, H5P_DEFAULT, raw_mask, offset.data(), raw.size(), raw.data()) < 0)
+                {
+                    throw std::runtime_error("Failed to write chunk");
+                }
+                metrics.reset();
+                compare_chunk(type, raw.data(), raw.data(), ndims, chunk_dims.data(), count.data(), metrics);
+                summary.lossless++;
+            }
+            summary.chunks++;
+            summary.metrics.merge(metrics);
+        }
+    }
+    catch(...)
+    {
+        H5Dclose(scratch);
+        H5Fclose(scratch_file);
+        throw;
+    }
+    H5Dclose(scratch);
+    H5Fclose(scratch_file);
+    return true;
 }
 
-void H5Zio::open(const std::string &filename, std::string fmode)
+bool H5Zio::read_chunks(hid_t dataset_id, hid_t mem_type, void* data, const hsize_t start[], const hsize_t count[],
+                        H5ZioDatasetStats* record)
 {
-    if(is_open)
+    H5ZIO_TRACE("read_chunks");
+    H5ZioChunkCodec codec(dataset_id);
+    if(!codec.is_supported())
     {
-        close();
+        return false;
+    }
+    // conversão de tipos fica a cargo do HDF5
+    hid_t file_type = H5Dget_type(dataset_id);
+    bool  same_type = H5Tequal(file_type, mem_type) > 0;
+    H5Tclose(file_type);
+    if(!same_type)
+    {
+        return false;
     }
 
-    file_name = filename;
-
-    if(fmode == "a")
+    hid_t space = H5Dget_space(dataset_id);
+    int   ndims = H5Sget_simple_extent_ndims(space);
+    if(ndims != codec.get_ndims())
     {
-        file_id = H5Fopen(filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
-        mode    = H5ZIO::FileMode::APPEND;
+        H5Sclose(space);
+        return false;
     }
-    else if(fmode == "w")
+    std::vector<hsize_t> dims(ndims);
+    H5Sget_simple_extent_dims(space, dims.data(), NULL);
+
+    // região lida: o dataset inteiro se start/count não forem informados
+    std::vector<hsize_t> region_start(ndims, 0), region_count(dims);
+    if(start != nullptr && count != nullptr)
     {
-        file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-        mode    = H5ZIO::FileMode::WRITE;
+        region_start.assign(start, start + ndims);
+        region_count.assign(count, count + ndims);
     }
-    else if(fmode == "r")
+    hid_t mem_space = H5Screate_simple(ndims, region_count.data(), NULL);
+
+    H5ZioChunkGrid   grid(ndims, dims.data(), codec.get_chunk_dims(), region_start.data(), region_count.data());
+    H5ZioThreadPool& pool = thread_pool();
+    size_t           elem_size = codec.get_element_size();
+
+    // a leitura dos chunks fica nesta thread; a decodificação e a cópia 
+    // para o buffer do usuário rodam no pool
+    // cada tarefa retorna o seu tempo e o dos filtros (H5ZioChunkCodec::decode)
+    std::deque<std::future<std::pair<double, double> > > pending;
+    size_t window = 2 * pool.size();
+    H5ZioMemoryTracker memory;
+    H5ZioTimer         timer;
+    double             io_seconds = 0.0, decode_seconds = 0.0;
+    H5ZioDatasetStats* filters = H5ZioFilterTimer::current();
+    auto finish = [&]() {
+        std::pair<double, double> seconds = pending.front().get();
+        decode_seconds += seconds.first;
+        if(filters != nullptr)
+        {
+            filters->filter_seconds   += seconds.second;
+            filters->max_chunk_seconds = std::max(filters->max_chunk_seconds, seconds.second);
+        }
+        pending.pop_front();
+    };
+
+    try
     {
-        file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-        mode    = H5ZIO::FileMode::READ;
+        for(hsize_t c = 0; c < grid.size(); c++)
+        {
+            std::vector<hsize_t> offset(ndims), valid(ndims);
+            grid.chunk(c, offset.data(), valid.data());
+
+            // interseção entre o chunk e a região
+            std::vector<hsize_t> in_chunk(ndims), in_region(ndims), box(ndims);
+            for(int i = 0; i < ndims; i++)
+            {
+                hsize_t first = std::max(offset[i], region_start[i]);
+                hsize_t last  = std::min(offset[i] + valid[i], region_start[i] + region_count[i]);
+                in_chunk[i]  = first - offset[i];
+                in_region[i] = first - region_start[i];
+                box[i]       = last - first;
+            }
+
+            hsize_t  nbytes = 0;
+            uint32_t filter_mask = 0;
+            std::shared_ptr<std::vector<unsigned char> > raw;
+            timer.lap();
+            bool direct = H5Dget_chunk_storage_size(dataset_id, offset.data(), &nbytes) >= 0 && nbytes > 0;
+            if(direct)
+            {
+                H5ZIO_TRACE("H5Dread_chunk");
+                raw = std::make_shared<std::vector<unsigned char> >(nbytes);
+                direct = H5Dread_chunk(dataset_id, H5P_DEFAULT, offset.data(), &filter_mask, raw->data()) >= 0 && filter_mask == 0;
+            }
+            io_seconds += timer.lap();
+            if(!direct)
+            {
+                // chunk não alocado ou gravado sem o filtro: leitura pelo pipeline do HDF5
+                std::vector<hsize_t> file_pos(ndims);
+                for(int i = 0; i < ndims; i++)
+                {
+                    file_pos[i] = offset[i] + in_chunk[i];
+                }
+                H5Sselect_hyperslab(space, H5S_SELECT_SET, file_pos.data(), NULL, box.data(), NULL);
+                H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, in_region.data(), NULL, box.data(), NULL);
+                H5ZIO_TRACE("H5Dread");
+                if(H5Dread(dataset_id, mem_type, mem_space, space, H5P_DEFAULT, data) < 0)
+                {
+                    throw std::runtime_error("Failed to read chunk");
+                }
+                io_seconds += timer.lap();
+                continue;
+            }
 
+            // o chunk lido é contabilizado até o fim da decodificação
+            memory.acquire(raw->size());
+            if(filters != nullptr)
+            {
+                H5ZioFilterTimer::add_chunk(filters, raw->size(), codec.get_chunk_bytes(), 0.0);
+            }
+            pending.emplace_back(pool.submit([&codec, &region_count, &memory, raw, data, ndims, in_chunk, in_region, box, elem_size]() {
+                H5ZIO_TRACE("decode_chunk");
+                H5ZioTimer decode_timer;
+                memory.acquire(codec.get_chunk_bytes());
+                std::unique_ptr<unsigned char[]> chunk(new unsigned char[codec.get_chunk_bytes()]);
+                codec.decode(raw->data(), raw->size(), chunk.get());
+                double filter_seconds = decode_timer.lap();
+                H5ZIO::copy_box(ndims, elem_size, box.data(), chunk.get(), codec.get_chunk_dims(), in_chunk.data(),
+                                data, region_count.data(), in_region.data());
+                memory.release(codec.get_chunk_bytes() + raw->size());
+                return std::make_pair(filter_seconds + decode_timer.lap(), filter_seconds);
+            }));
+
+            while(pending.size() >= window)
+            {
+                finish();
+            }
+        }
+        while(!pending.empty())
+        {
+            finish();
+        }
     }
-    else
+    catch(...)
     {
-        throw std::runtime_error("Invalid mode");
+        for(auto& p : pending)
+        {
+            p.wait();
+        }
+        H5Sclose(mem_space);
+        H5Sclose(space);
+        throw;
     }
-    if(this->verbose_level > 1)
+    H5Sclose(mem_space);
+    H5Sclose(space);
+    if(record != nullptr)
     {
-        std::cout << "File " << filename << " opened" << std::endl;
-        std::cout << "Mode: " << mode << std::endl;
-        std::cout << "File ID: " << file_id << std::endl;
+        record->io_seconds          += io_seconds;
+        record->compression_seconds += decode_seconds;
+        record->peak_buffer_bytes    = std::max(record->peak_buffer_bytes, memory.get_peak());
     }
-    is_open = true;
+    return true;
 }
 
-
-
-void H5Zio::close()
+void H5Zio::read_region(hid_t dataset_id, hid_t mem_type, const hsize_t offset[], const hsize_t count[], const hsize_t stride[], void* data)
 {
-    H5Fclose(file_id);
-    is_open = false;
-}
+    hid_t space = H5Dget_space(dataset_id);
+    int   ndims = H5Sget_simple_extent_ndims(space);
+    std::vector<hsize_t> dims(ndims);
+    H5Sget_simple_extent_dims(space, dims.data(), NULL);
 
-H5Dimensions H5Zio::dataset_dimensions(std::string dataset)
-{
-    // vefificar se o arquivo foi aberto em modo de leitura
-    if(mode != H5ZIO::FileMode::READ)
+    bool unit_stride = true;
+    for(int i = 0; i < ndims; i++)
     {
-        throw std::runtime_error("File not opened in read mode");
+        hsize_t step = (stride != nullptr) ? stride[i] : 1;
+        if(count[i] == 0 || step == 0 || offset[i] + (count[i] - 1) * step >= dims[i])
+        {
+            H5Sclose(space);
+            throw std::runtime_error("Region is out of the dataset bounds");
+        }
+        unit_stride = unit_stride && step == 1;
     }
 
-    // abrir dataset
-    hid_t dset = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
-    if(dset < 0)
+    // com stride unitário os chunks que interceptam a região são decodificados em paralelo
+    if(num_threads > 1 && unit_stride && read_chunks(dataset_id, mem_type, data, offset, count))
     {
-        throw std::runtime_error("Dataset not found");
+        H5Sclose(space);
+        return;
     }
 
-    // obter dimensões
-    H5Dimensions dims;
-    hid_t space = H5Dget_space(dset);
-    int ndims = H5Sget_simple_extent_ndims(space);
-    hsize_t _dims[ndims];
-    dims.set_dimensions(ndims, _dims);
-    H5Sget_simple_extent_dims(space, dims.get_dims(), NULL);
+    // o HDF5 descomprime somente os chunks que interceptam a seleção
+    H5ZIO_TRACE("H5Dread");
+    hid_t mem_space = H5Screate_simple(ndims, count, NULL);
+    H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, stride, count, NULL);
+    herr_t status = H5Dread(dataset_id, mem_type, mem_space, space, H5P_DEFAULT, data);
+    H5Sclose(mem_space);
     H5Sclose(space);
-    H5Dclose(dset);
-    
-    return dims;
+    if(status < 0)
+    {
+        throw std::runtime_error("Failed to read region");
+    }
 }
 
 void H5Zio::get_datasets_info(std::vector<dataset_info>& datasets, std::vector<std::string> &groups_list)
@@ -503,13 +2423,213 @@ void H5Zio::create_groups(std::vector<std::string> &groups)
 
 
 namespace H5ZIO {
-void compress(const std::string& input_file, const std::string& output_file, H5ZIOParameters& parameters)
+
+// Copia um dataset para o arquivo de saída. Datasets pequenos são copiados 
+// inteiros; os demais, ou todos se houver mais de uma thread, passam pelo 
+// pipeline de blocos de copy_dataset
+template <typename T>
+static void compress_dataset(H5Zio& input, H5Zio& output, const std::string& name, H5ZIOParameters* parameters, hsize_t memory_budget)
+{
+    H5ZIO_TRACE("H5ZIO::compress_dataset");
+    H5Dimensions dims = input.dataset_dimensions(name);
+
+    // AUTO: compressor escolhido por amostragem e registrado em um atributo
+    if(parameters != nullptr && parameters->get_compression_type() == H5ZIO::Type::AUTO)
+    {
+        if(dims.get_ndims() == 0)
+        {
+            compress_dataset<T>(input, output, name, nullptr, memory_budget);
+            return;
+        }
+        H5ZioTuner      tuner;
+        H5ZIOParameters selected;
+        {
+            H5ZIO_TRACE("select_codec");
+            selected = tuner.select_codec<T>(input, name, *parameters);
+        }
+        compress_dataset<T>(input, output, name, &selected, memory_budget);
+
+        H5ZioAttribute attributes;
+        attributes.create_attribute("h5zio_codec", compression_type_names[static_cast<int>(selected.get_compression_type())]);
+        output.write_attributes(name, &attributes);
+        return;
+    }
+
+    if(dims.get_ndims() == 0 || (output.get_num_threads() < 2 && dims.total_size() * sizeof(T) <= memory_budget))
+    {
+        // sem inicialização: o HDF5 sobrescreve todo o vetor
+        std::vector<T, H5ZIO::aligned_allocator<T> > data;
+        input.read_dataset<T>(name, data);
+        output.write_dataset<T>(name, data.data(), dims, parameters);
+        return;
+    }
+    output.copy_dataset<T>(input, name, parameters, memory_budget);
+}
+
+// Copia um dataset de tipo numérico nativo com compress_dataset
+static bool compress_native(H5Zio& input, H5Zio& output, const std::string& name, hid_t native, H5ZioPolicy& policy, 
+                            hsize_t memory_budget)
+{
+    if(H5Tequal(native, H5T_NATIVE_FLOAT) > 0)
+    {
+        compress_dataset<float>(input, output, name, policy.find(name, true), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_DOUBLE) > 0)
+    {
+        compress_dataset<double>(input, output, name, policy.find(name, true), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_INT) > 0)
+    {
+        compress_dataset<int>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_LONG) > 0)
+    {
+        compress_dataset<long>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_LLONG) > 0)
+    {
+        compress_dataset<long long>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_UCHAR) > 0)
+    {
+        compress_dataset<unsigned char>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_UINT) > 0)
+    {
+        compress_dataset<unsigned int>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_ULONG) > 0)
+    {
+        compress_dataset<unsigned long>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_ULLONG) > 0)
+    {
+        compress_dataset<unsigned long long>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_SHORT) > 0)
+    {
+        compress_dataset<short>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_USHORT) > 0)
+    {
+        compress_dataset<unsigned short>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    if(H5Tequal(native, H5T_NATIVE_CHAR) > 0)
+    {
+        compress_dataset<char>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    // somente em plataformas com char sem sinal
+    if(H5Tequal(native, H5T_NATIVE_SCHAR) > 0)
+    {
+        compress_dataset<signed char>(input, output, name, policy.find(name, false), memory_budget);
+        return true;
+    }
+
+    return false;
+}
+
+// Copia sem conversão um dataset que compress_dataset não processa (strings, compostos, enums, arrays...).
+// Sem filtros, com H5Ocopy; com filtros, o dataset é lido inteiro com o tipo do arquivo e gravado sem filtros
+static void copy_raw_dataset(H5Zio& input, H5Zio& output, const std::string& name)
+{
+    H5ZIO_TRACE("H5ZIO::copy_raw_dataset");
+    hid_t dset = H5Dopen(input.get_file_id(), name.c_str(), H5P_DEFAULT);
+    if(dset < 0)
+    {
+        throw std::runtime_error("Failed to open dataset " + name);
+    }
+    hid_t dcpl     = H5Dget_create_plist(dset);
+    int   nfilters = H5Pget_nfilters(dcpl);
+    H5Pclose(dcpl);
+    if(nfilters == 0)
+    {
+        H5Dclose(dset);
+        if(H5Ocopy(input.get_file_id(), name.c_str(), output.get_file_id(), name.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+        {
+            throw std::runtime_error("Failed to copy dataset " + name);
+        }
+        return;
+    }
+
+    hid_t type  = H5Dget_type(dset);
+    hid_t space = H5Dget_space(dset);
+    // a saída é contígua: sem dimensões ilimitadas
+    hid_t out_space = H5Scopy(space);
+    if(H5Sget_simple_extent_type(space) == H5S_SIMPLE)
+    {
+        int ndims = H5Sget_simple_extent_ndims(space);
+        std::vector<hsize_t> dims(ndims);
+        H5Sget_simple_extent_dims(space, dims.data(), NULL);
+        H5Sset_extent_simple(out_space, ndims, dims.data(), NULL);
+    }
+
+    hssize_t points = H5Sget_select_npoints(space);
+    std::vector<unsigned char> data(std::max<hssize_t>(points, 1) * H5Tget_size(type));
+    herr_t status = H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+    hid_t  out    = H5Dcreate(output.get_file_id(), name.c_str(), type, out_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(status >= 0 && out >= 0)
+    {
+        status = H5Dwrite(out, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+    }
+    if(status >= 0)
+    {
+        // strings e sequências de tamanho variável alocadas pelo H5Dread
+        H5Dvlen_reclaim(type, space, H5P_DEFAULT, data.data());
+    }
+    if(out >= 0) H5Dclose(out);
+    H5Sclose(out_space);
+    H5Sclose(space);
+    H5Tclose(type);
+    H5Dclose(dset);
+    if(status < 0 || out < 0)
+    {
+        throw std::runtime_error("Failed to copy dataset " + name);
+    }
+}
+
+void compress(const std::string& input_file, const std::string& output_file, H5ZIOParameters& parameters, hsize_t memory_budget, 
+              unsigned int num_threads)
+{
+    H5ZioPolicy policy;
+    policy.set_default(parameters, H5ZIO::Elements::FLOAT);
+    compress(input_file, output_file, policy, memory_budget, num_threads);
+}
+
+void compress(const std::string& input_file, const std::string& output_file, H5ZioPolicy& policy, hsize_t memory_budget, 
+              unsigned int num_threads)
 {
+    H5ZIO_TRACE("H5ZIO::compress");
     H5Zio input;
     H5Zio output;
     input.open(input_file, "r");
     output.open(output_file, "w");
     output.set_verbose_level(1);
+    input.set_num_threads(num_threads);
+    output.set_num_threads(num_threads);
 
     std::vector<dataset_info> datasets;
     std::vector<std::string> groups;
@@ -523,115 +2643,51 @@ void compress(const std::string& input_file, const std::string& output_file, H5Z
         hid_t dset = H5Dopen(input.get_file_id(), datasets[i].first.c_str(), H5P_DEFAULT);
         hid_t type = H5Dget_type(dset);
         H5Dclose(dset);
-
-        if(H5Tequal(type, H5T_NATIVE_FLOAT) > 0)
-        {
-            std::vector<float> data;
-            auto dims = input.read_dataset<float>(datasets[i].first, data);
-            output.write_dataset<float>(datasets[i].first, data.data(), dims, &parameters);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_DOUBLE) > 0)
-        {
-            std::vector<double> data;
-            auto dims = input.read_dataset<double>(datasets[i].first, data);
-            output.write_dataset<double>(datasets[i].first, data.data(),dims, &parameters);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_INT) > 0)
-        {
-            std::vector<int> data;
-            auto dims = input.read_dataset<int>(datasets[i].first, data);
-            output.write_dataset<int>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_LONG) > 0)
-        {
-            std::vector<long> data;
-            auto dims = input.read_dataset<long>(datasets[i].first, data);
-            output.write_dataset<long>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_LLONG) > 0)
-        {
-            std::vector<long long> data;
-            auto dims = input.read_dataset<long long>(datasets[i].first, data);
-            output.write_dataset<long long>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_UCHAR) > 0)
-        {
-            std::vector<unsigned char> data;
-            auto dims = input.read_dataset<unsigned char>(datasets[i].first, data);
-            output.write_dataset<unsigned char>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_UINT) > 0)
-        {
-            std::vector<unsigned int> data;
-            auto dims = input.read_dataset<unsigned int>(datasets[i].first, data);
-            output.write_dataset<unsigned int>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_ULONG) > 0)
-        {
-            std::vector<unsigned long> data;
-            auto dims = input.read_dataset<unsigned long>(datasets[i].first, data);
-            output.write_dataset<unsigned long>(datasets[i].first, data.data(), dims);
-            continue;
-        }
-
-        if(H5Tequal(type, H5T_NATIVE_ULLONG) > 0)
+        if(type < 0)
         {
-            std::vector<unsigned long long> data;
-            auto dims = input.read_dataset<unsigned long long>(datasets[i].first, data);
-            output.write_dataset<unsigned long long>(datasets[i].first, data.data(), dims);
-            continue;
+            throw std::runtime_error("Failed to open dataset " + datasets[i].first);
         }
 
-        if(H5Tequal(type, H5T_NATIVE_SHORT) > 0)
+        // inteiros e reais em outra ordem de bytes são lidos com o tipo nativo correspondente
+        hid_t       native     = -1;
+        H5T_class_t type_class = H5Tget_class(type);
+        if(type_class == H5T_INTEGER || type_class == H5T_FLOAT)
         {
-            std::vector<short> data;
-            auto dims = input.read_dataset<short>(datasets[i].first, data);
-            output.write_dataset<short>(datasets[i].first, data.data(), dims);
-            continue;
+            native = H5Tget_native_type(type, H5T_DIR_ASCEND);
         }
+        H5Tclose(type);
 
-        if(H5Tequal(type, H5T_NATIVE_USHORT) > 0)
+        bool compressed = false;
+        try
         {
-            std::vector<unsigned short> data;
-            auto dims = input.read_dataset<unsigned short>(datasets[i].first, data);
-            output.write_dataset<unsigned short>(datasets[i].first, data.data(), dims);
-            continue;
+            compressed = native >= 0 && compress_native(input, output, datasets[i].first, native, policy, memory_budget);
         }
-
-        if(H5Tequal(type, H5T_NATIVE_CHAR) > 0)
+        catch(...)
         {
-            std::vector<char> data;
-            auto dims = input.read_dataset<char>(datasets[i].first, data);
-            output.write_dataset<char>(datasets[i].first, data.data(), dims);
-            continue;
+            H5Tclose(native);
+            throw;
         }
+        if(native >= 0) H5Tclose(native);
 
-        if(H5Tequal(type, H5T_NATIVE_UCHAR) > 0)
+        if(!compressed)
         {
-            std::vector<unsigned char> data;
-            auto dims = input.read_dataset<unsigned char>(datasets[i].first, data);
-            output.write_dataset<unsigned char>(datasets[i].first, data.data(), dims);
-            continue;
+            copy_raw_dataset(input, output, datasets[i].first);
         }
-
     }
 
 }
 
+void decompress(const std::string& input_file, const std::string& output_file, unsigned int num_threads, hsize_t memory_budget)
+{
+    // sem filtro os datasets são criados contíguos e copiados por blocos
+    H5ZIOParameters uncompressed;
+    uncompressed.set_compression_type(H5ZIO::Type::NONE);
+    H5ZioPolicy policy;
+    policy.set_default(uncompressed, H5ZIO::Elements::FLOAT);
+    policy.set_default(uncompressed, H5ZIO::Elements::INTEGER);
+    compress(input_file, output_file, policy, memory_budget, num_threads);
+}
+
 
 
 }
@@ -0,0 +1,89 @@
+#include "h5zio_buffer.h"
+
+#include <cstdlib>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+void* H5ZIO::aligned_malloc(size_t bytes)
+{
+    void* ptr = nullptr;
+    if(posix_memalign(&ptr, BUFFER_ALIGNMENT, bytes > 0 ? bytes : BUFFER_ALIGNMENT) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void H5ZIO::aligned_free(void* ptr)
+{
+    free(ptr);
+}
+
+void* H5ZIO::map_file(const std::string& file_name, size_t offset, size_t bytes, void*& base, size_t& length)
+{
+    base   = nullptr;
+    length = 0;
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        return nullptr;
+    }
+    // mmap exige deslocamento múltiplo do tamanho da página
+    size_t page  = sysconf(_SC_PAGESIZE);
+    size_t start = (offset / page) * page;
+    size_t size  = offset - start + bytes;
+    void*  addr  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, start);
+    ::close(fd);
+    if(addr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    base   = addr;
+    length = size;
+    return static_cast<char*>(addr) + (offset - start);
+}
+
+void H5ZIO::unmap_file(void* base, size_t length)
+{
+    munmap(base, length);
+}
+
+void* H5ZioBufferPool::acquire(size_t bytes, size_t& capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // menor buffer livre que comporte a requisição
+        auto it = free_buffers.lower_bound(bytes);
+        if(it != free_buffers.end() && it->first / 2 <= bytes)
+        {
+            void* buffer  = it->second;
+            capacity      = it->first;
+            cached_bytes -= it->first;
+            free_buffers.erase(it);
+            return buffer;
+        }
+    }
+    // arredonda para o alinhamento; a memória não é inicializada
+    capacity = ((bytes + H5ZIO::BUFFER_ALIGNMENT - 1) / H5ZIO::BUFFER_ALIGNMENT) * H5ZIO::BUFFER_ALIGNMENT;
+    if(capacity == 0) capacity = H5ZIO::BUFFER_ALIGNMENT;
+    return H5ZIO::aligned_malloc(capacity);
+}
+
+void H5ZioBufferPool::release(void* buffer, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free_buffers.emplace(capacity, buffer);
+    cached_bytes += capacity;
+}
+
+void H5ZioBufferPool::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& buffer : free_buffers)
+    {
+        H5ZIO::aligned_free(buffer.second);
+    }
+    free_buffers.clear();
+    cached_bytes = 0;
+}
@@ -0,0 +1,472 @@
+
+#include "h5zio_codec.h"
+#include "h5zio_intpack.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+#include <algorithm>
+
+#ifdef H5ZIO_HAS_ZLIB
+#include <zlib.h>
+#endif // H5ZIO_HAS_ZLIB
+
+#ifdef H5ZIO_HAS_SZ
+#include "sz.h"
+#include "H5Z_SZ.h"
+#endif // SZ_HDF5
+
+#ifdef H5ZIO_HAS_ZFP
+#include "zfp.h"
+#include "H5Zzfp.h"
+#endif // ZFP_HDF5
+
+namespace H5ZIO {
+
+void copy_box(hsize_t ndims, size_t elem_size, const hsize_t count[],
+              const void* src, const hsize_t src_dims[], const hsize_t src_start[],
+              void* dst, const hsize_t dst_dims[], const hsize_t dst_start[])
+{
+    const char* in  = static_cast<const char*>(src);
+    char*       out = static_cast<char*>(dst);
+
+    if(ndims == 0)
+    {
+        std::memcpy(out, in, elem_size);
+        return;
+    }
+    for(int i = 0; i < ndims; i++)
+    {
+        if(count[i] == 0) return;
+    }
+
+    std::vector<hsize_t> src_stride(ndims), dst_stride(ndims);
+    src_stride[ndims-1] = 1;
+    dst_stride[ndims-1] = 1;
+    for(int i = ndims - 2; i >= 0; i--)
+    {
+        src_stride[i] = src_stride[i+1] * src_dims[i+1];
+        dst_stride[i] = dst_stride[i+1] * dst_dims[i+1];
+    }
+
+    // a última dimensão é contígua nos dois arrays: copia linha a linha
+    size_t row_bytes = count[ndims-1] * elem_size;
+    std::vector<hsize_t> idx(ndims, 0);
+    while(true)
+    {
+        hsize_t src_pos = 0, dst_pos = 0;
+        for(int i = 0; i < ndims; i++)
+        {
+            src_pos += (src_start[i] + idx[i]) * src_stride[i];
+            dst_pos += (dst_start[i] + idx[i]) * dst_stride[i];
+        }
+        std::memcpy(out + dst_pos * elem_size, in + src_pos * elem_size, row_bytes);
+
+        int k = ndims - 2;
+        while(k >= 0)
+        {
+            if(++idx[k] < count[k]) break;
+            idx[k] = 0;
+            k--;
+        }
+        if(k < 0) break;
+    }
+}
+
+}
+
+H5ZioChunkGrid::H5ZioChunkGrid(hsize_t ndims, const hsize_t dims[], const hsize_t chunk_dims[], 
+                               const hsize_t region_start[], const hsize_t region_count[])
+{
+    this->ndims = ndims;
+    this->dims.assign(dims, dims + ndims);
+    this->chunk_dims.assign(chunk_dims, chunk_dims + ndims);
+    this->first_chunk.resize(ndims);
+    this->nchunks.resize(ndims);
+    for(int i = 0; i < ndims; i++)
+    {
+        if(chunk_dims[i] == 0)
+        {
+            throw std::runtime_error("Invalid chunk dimensions");
+        }
+        hsize_t start = 0, end = dims[i];
+        if(region_start != nullptr && region_count != nullptr)
+        {
+            start = region_start[i];
+            end   = std::min(dims[i], region_start[i] + region_count[i]);
+        }
+        if(start >= end)
+        {
+            first_chunk[i] = 0;
+            nchunks[i]     = 0;
+            continue;
+        }
+        first_chunk[i] = start / chunk_dims[i];
+        nchunks[i]     = (end - 1) / chunk_dims[i] - first_chunk[i] + 1;
+    }
+}
+
+hsize_t H5ZioChunkGrid::size()
+{
+    hsize_t n = 1;
+    for(int i = 0; i < ndims; i++)
+    {
+        n *= nchunks[i];
+    }
+    return n;
+}
+
+void H5ZioChunkGrid::chunk(hsize_t index, hsize_t offset[], hsize_t count[])
+{
+    for(int i = ndims - 1; i >= 0; i--)
+    {
+        hsize_t pos = first_chunk[i] + index % nchunks[i];
+        index      /= nchunks[i];
+        offset[i]   = pos * chunk_dims[i];
+        count[i]    = std::min(chunk_dims[i], dims[i] - offset[i]);
+    }
+}
+
+#ifdef H5ZIO_HAS_SZ
+// O SZ2 mantém a configuração em variáveis globais: as chamadas são serializadas
+static std::mutex sz_mutex;
+#endif
+
+#ifdef H5ZIO_HAS_ZFP
+// O H5Z-ZFP guarda a versão em cd_values[0] e o cabeçalho completo
+// do ZFP (modo, tipo e dimensões do chunk) a partir de cd_values[1].
+// Cada chunk gravado pelo filtro (H5Z_filter_zfp) também começa com
+// esse cabeçalho (zfp_write_header com ZFP_HEADER_FULL), seguido do
+// fluxo comprimido; na leitura o filtro o lê antes de descomprimir
+static zfp_stream* zfp_stream_from_cd_values(const std::vector<unsigned int>& cd_values, zfp_field* field)
+{
+    if(cd_values.size() < 2)
+    {
+        throw std::runtime_error("Invalid ZFP filter parameters");
+    }
+    std::vector<unsigned int> header(cd_values.begin() + 1, cd_values.end());
+    bitstream*  stream = stream_open(header.data(), header.size() * sizeof(unsigned int));
+    zfp_stream* zfp    = zfp_stream_open(stream);
+    size_t bits = zfp_read_header(zfp, field, ZFP_HEADER_FULL);
+    zfp_stream_set_bit_stream(zfp, NULL);
+    stream_close(stream);
+    if(bits == 0)
+    {
+        zfp_stream_close(zfp);
+        throw std::runtime_error("Invalid ZFP header");
+    }
+    return zfp;
+}
+#endif
+
+// Reordenação do filtro shuffle do HDF5: o byte j de todos os elementos fica
+// contíguo; bytes que não completam um elemento são copiados ao final
+static void shuffle_bytes(const void* in, size_t bytes, size_t element_size, void* out)
+{
+    const unsigned char* src   = static_cast<const unsigned char*>(in);
+    unsigned char*       dst   = static_cast<unsigned char*>(out);
+    size_t               count = bytes / element_size;
+    for(size_t j = 0; j < element_size; j++)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[j * count + i] = src[i * element_size + j];
+        }
+    }
+    std::memcpy(dst + count * element_size, src + count * element_size, bytes - count * element_size);
+}
+
+static void unshuffle_bytes(const void* in, size_t bytes, size_t element_size, void* out)
+{
+    const unsigned char* src   = static_cast<const unsigned char*>(in);
+    unsigned char*       dst   = static_cast<unsigned char*>(out);
+    size_t               count = bytes / element_size;
+    for(size_t j = 0; j < element_size; j++)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i * element_size + j] = src[j * count + i];
+        }
+    }
+    std::memcpy(dst + count * element_size, src + count * element_size, bytes - count * element_size);
+}
+
+H5ZioChunkCodec::H5ZioChunkCodec(hid_t dataset_id): supported(false), shuffle(false), filter(H5Z_FILTER_NONE), flags(0), type_id(-1), element_size(0)
+{
+    type_id      = H5Dget_type(dataset_id);
+    element_size = H5Tget_size(type_id);
+
+    hid_t dcpl     = H5Dget_create_plist(dataset_id);
+    int   nfilters = H5Pget_nfilters(dcpl);
+    if(H5Pget_layout(dcpl) != H5D_CHUNKED || nfilters < 1 || nfilters > 2)
+    {
+        H5Pclose(dcpl);
+        return;
+    }
+
+    int ndims = H5Pget_chunk(dcpl, 0, NULL);
+    chunk_dims.resize(ndims);
+    H5Pget_chunk(dcpl, ndims, chunk_dims.data());
+
+    // dois filtros: somente shuffle seguido do compressor
+    if(nfilters == 2)
+    {
+        unsigned int shuffle_flags;
+        size_t       shuffle_nelmts = 0;
+        shuffle = H5Pget_filter2(dcpl, 0, &shuffle_flags, &shuffle_nelmts, NULL, 0, NULL, NULL) == H5Z_FILTER_SHUFFLE;
+        if(!shuffle)
+        {
+            H5Pclose(dcpl);
+            return;
+        }
+    }
+
+    size_t cd_nelmts = 32;
+    cd_values.resize(cd_nelmts);
+    filter = H5Pget_filter2(dcpl, nfilters - 1, &flags, &cd_nelmts, cd_values.data(), 0, NULL, NULL);
+    if(cd_nelmts > cd_values.size())
+    {
+        cd_values.resize(cd_nelmts);
+        filter = H5Pget_filter2(dcpl, nfilters - 1, &flags, &cd_nelmts, cd_values.data(), 0, NULL, NULL);
+    }
+    cd_values.resize(cd_nelmts);
+    H5Pclose(dcpl);
+
+#ifdef H5ZIO_HAS_ZLIB
+    if(filter == H5Z_FILTER_DEFLATE) supported = true;
+#endif
+    if(shuffle && filter != H5Z_FILTER_DEFLATE)
+    {
+        return;
+    }
+    // cd_values: versão, tamanho do elemento e sinal (intpack_set_local)
+    if(filter == H5ZIO::FILTER_INTPACK)
+    {
+        supported = cd_values.size() >= 3 && cd_values[1] == element_size;
+    }
+#ifdef H5ZIO_HAS_ZFP
+    if(filter == H5Z_FILTER_ZFP)
+    {
+        zfp_field*  field = zfp_field_alloc();
+        zfp_stream* zfp   = zfp_stream_from_cd_values(cd_values, field);
+        // o cabeçalho omite dimensões unitárias, mas o número de valores é o mesmo
+        supported = zfp_field_size(field, NULL) * element_size == get_chunk_bytes() &&
+                    zfp_type_size(zfp_field_type(field)) == element_size;
+        zfp_field_free(field);
+        zfp_stream_close(zfp);
+    }
+#endif
+#ifdef H5ZIO_HAS_SZ
+    if(filter == H5Z_FILTER_SZ)
+    {
+        supported = H5Tget_class(type_id) == H5T_FLOAT;
+    }
+#endif
+}
+
+H5ZioChunkCodec::~H5ZioChunkCodec()
+{
+    if(type_id >= 0)
+    {
+        H5Tclose(type_id);
+    }
+}
+
+size_t H5ZioChunkCodec::get_chunk_bytes()
+{
+    size_t size = element_size;
+    for(int i = 0; i < chunk_dims.size(); i++)
+    {
+        size *= chunk_dims[i];
+    }
+    return size;
+}
+
+void H5ZioChunkCodec::encode(const void* chunk, std::vector<unsigned char>& out)
+{
+    if(!supported)
+    {
+        throw std::runtime_error("Chunk filter is not supported");
+    }
+    size_t chunk_bytes = get_chunk_bytes();
+
+    if(filter == H5ZIO::FILTER_INTPACK)
+    {
+        H5ZIO::intpack_encode(chunk, chunk_bytes / element_size, element_size, cd_values[2] != 0, out);
+        return;
+    }
+#ifdef H5ZIO_HAS_ZLIB
+    if(filter == H5Z_FILTER_DEFLATE)
+    {
+        std::vector<unsigned char> shuffled;
+        if(shuffle)
+        {
+            shuffled.resize(chunk_bytes);
+            shuffle_bytes(chunk, chunk_bytes, element_size, shuffled.data());
+            chunk = shuffled.data();
+        }
+        uLongf out_size = compressBound(chunk_bytes);
+        out.resize(out_size);
+        int level = cd_values.empty() ? Z_DEFAULT_COMPRESSION : cd_values[0];
+        if(compress2(out.data(), &out_size, static_cast<const Bytef*>(chunk), chunk_bytes, level) != Z_OK)
+        {
+            throw std::runtime_error("Failed to compress chunk with deflate");
+        }
+        out.resize(out_size);
+        return;
+    }
+#endif
+#ifdef H5ZIO_HAS_ZFP
+    if(filter == H5Z_FILTER_ZFP)
+    {
+        zfp_field*  field = zfp_field_alloc();
+        zfp_stream* zfp   = zfp_stream_from_cd_values(cd_values, field);
+        zfp_field_set_pointer(field, const_cast<void*>(chunk));
+        // o tamanho máximo inclui o cabeçalho (ZFP_HEADER_MAX_BITS)
+        size_t max_size = zfp_stream_maximum_size(zfp, field);
+        out.resize(max_size);
+        bitstream* stream = stream_open(out.data(), max_size);
+        zfp_stream_set_bit_stream(zfp, stream);
+        zfp_stream_rewind(zfp);
+        // mesmo formato do H5Z-ZFP: cabeçalho completo e dados; zfp_compress retorna o total em bytes
+        size_t out_size = zfp_write_header(zfp, field, ZFP_HEADER_FULL) > 0 ? zfp_compress(zfp, field) : 0;
+        stream_close(stream);
+        zfp_stream_close(zfp);
+        zfp_field_free(field);
+        if(out_size == 0)
+        {
+            throw std::runtime_error("Failed to compress chunk with ZFP");
+        }
+        out.resize(out_size);
+        return;
+    }
+#endif
+#ifdef H5ZIO_HAS_SZ
+    if(filter == H5Z_FILTER_SZ)
+    {
+        // como em H5Z_filter_sz: o chunk é o fluxo do SZ, sem cabeçalho. Com limites de erro
+        // em cd_values, SZ_compress_args; sem eles, SZ_compress com a configuração global
+        int dim_size, data_type, error_bound_mode = 0;
+        size_t r5, r4, r3, r2, r1;
+        double abs_error = 0.0, rel_error = 0.0, pw_rel_error = 0.0, psnr = 0.0;
+        bool   with_errors = checkCDValuesWithErrors(cd_values.size(), cd_values.data()) != 0;
+        if(with_errors)
+        {
+            SZ_cdArrayToMetaDataErr(cd_values.size(), cd_values.data(), &dim_size, &data_type, &r5, &r4, &r3, &r2, &r1,
+                                    &error_bound_mode, &abs_error, &rel_error, &pw_rel_error, &psnr);
+        }
+        else
+        {
+            SZ_cdArrayToMetaData(cd_values.size(), cd_values.data(), &dim_size, &data_type, &r5, &r4, &r3, &r2, &r1);
+        }
+
+        std::lock_guard<std::mutex> lock(sz_mutex);
+        if(confparams_cpr == NULL)
+        {
+            SZ_Init(NULL);
+        }
+        size_t out_size = 0;
+        unsigned char* bytes = NULL;
+        if(with_errors)
+        {
+            confparams_cpr->psnr = psnr;
+            bytes = SZ_compress_args(data_type, const_cast<void*>(chunk), &out_size, error_bound_mode,
+                                     abs_error, rel_error, pw_rel_error, r5, r4, r3, r2, r1);
+        }
+        else
+        {
+            bytes = SZ_compress(data_type, const_cast<void*>(chunk), &out_size, r5, r4, r3, r2, r1);
+        }
+        if(bytes == NULL)
+        {
+            throw std::runtime_error("Failed to compress chunk with SZ");
+        }
+        out.assign(bytes, bytes + out_size);
+        free(bytes);
+        return;
+    }
+#endif
+    throw std::runtime_error("Chunk filter is not supported");
+}
+
+void H5ZioChunkCodec::decode(const void* in, size_t in_size, void* chunk)
+{
+    if(!supported)
+    {
+        throw std::runtime_error("Chunk filter is not supported");
+    }
+    size_t chunk_bytes = get_chunk_bytes();
+
+    if(filter == H5ZIO::FILTER_INTPACK)
+    {
+        if(H5ZIO::intpack_decode(in, in_size, chunk, chunk_bytes) != chunk_bytes)
+        {
+            throw std::runtime_error("Failed to decompress intpack chunk");
+        }
+        return;
+    }
+#ifdef H5ZIO_HAS_ZLIB
+    if(filter == H5Z_FILTER_DEFLATE)
+    {
+        std::vector<unsigned char> shuffled(shuffle ? chunk_bytes : 0);
+        void*  target   = shuffle ? shuffled.data() : chunk;
+        uLongf out_size = chunk_bytes;
+        if(uncompress(static_cast<Bytef*>(target), &out_size, static_cast<const Bytef*>(in), in_size) != Z_OK || out_size != chunk_bytes)
+        {
+            throw std::runtime_error("Failed to decompress deflate chunk");
+        }
+        if(shuffle)
+        {
+            unshuffle_bytes(shuffled.data(), chunk_bytes, element_size, chunk);
+        }
+        return;
+    }
+#endif
+#ifdef H5ZIO_HAS_ZFP
+    if(filter == H5Z_FILTER_ZFP)
+    {
+        zfp_field*  field = zfp_field_alloc();
+        zfp_stream* zfp   = zfp_stream_from_cd_values(cd_values, field);
+        bitstream* stream = stream_open(const_cast<void*>(in), in_size);
+        zfp_stream_set_bit_stream(zfp, stream);
+        zfp_stream_rewind(zfp);
+        // o cabeçalho do chunk define o modo e o formato, como em H5Z_filter_zfp; o número
+        // de valores deve ser o do chunk do dataset
+        size_t read = 0;
+        if(zfp_read_header(zfp, field, ZFP_HEADER_FULL) > 0 && zfp_field_size(field, NULL) * element_size == chunk_bytes)
+        {
+            zfp_field_set_pointer(field, chunk);
+            read = zfp_decompress(zfp, field);
+        }
+        stream_close(stream);
+        zfp_stream_close(zfp);
+        zfp_field_free(field);
+        if(read == 0)
+        {
+            throw std::runtime_error("Failed to decompress ZFP chunk");
+        }
+        return;
+    }
+#endif
+#ifdef H5ZIO_HAS_SZ
+    if(filter == H5Z_FILTER_SZ)
+    {
+        int dim_size, data_type;
+        size_t r5, r4, r3, r2, r1;
+        SZ_cdArrayToMetaData(cd_values.size(), cd_values.data(), &dim_size, &data_type, &r5, &r4, &r3, &r2, &r1);
+
+        std::lock_guard<std::mutex> lock(sz_mutex);
+        if(confparams_dec == NULL)
+        {
+            SZ_Init(NULL);
+        }
+        size_t count = SZ_decompress_args(data_type, static_cast<unsigned char*>(const_cast<void*>(in)), in_size, chunk, r5, r4, r3, r2, r1);
+        if(count * element_size != chunk_bytes)
+        {
+            throw std::runtime_error("Failed to decompress SZ chunk");
+        }
+        return;
+    }
+#endif
+    throw std::runtime_error("Chunk filter is not supported");
+}
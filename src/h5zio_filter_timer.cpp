@@ -0,0 +1,169 @@
+#include "h5zio_filter_timer.h"
+
+#include <mutex>
+#include <algorithm>
+
+const int H5ZioFilterTimer::MAX_FILTERS;
+
+// Cada filtro registrado com register_class ocupa uma posição fixa: a classe original
+// de uma posição nunca é sobrescrita, e uma execução em andamento de timed_filter<SLOT>
+// sempre encontra a função que deve chamar
+static std::mutex   filter_mutex;
+static int          filter_count = 0;
+static int          filter_users = 0;
+static H5Z_class2_t original_filters[H5ZioFilterTimer::MAX_FILTERS];
+static bool         installed[H5ZioFilterTimer::MAX_FILTERS];
+
+static thread_local H5ZioDatasetStats* current_record = nullptr;
+
+static size_t timed_filter(int slot, unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                           size_t nbytes, size_t* buf_size, void** buf)
+{
+    H5Z_func_t         filter = original_filters[slot].filter;
+    H5ZioDatasetStats* record = current_record;
+    if(record == nullptr)
+    {
+        return filter(flags, cd_nelmts, cd_values, nbytes, buf_size, buf);
+    }
+    H5ZioTimer timer;
+    size_t     output  = filter(flags, cd_nelmts, cd_values, nbytes, buf_size, buf);
+    H5ZioFilterTimer::add_chunk(record, nbytes, output, timer.lap());
+    return output;
+}
+
+// H5Z_func_t não recebe o identificador do filtro: uma função por posição
+template <int SLOT>
+static size_t timed_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                           size_t nbytes, size_t* buf_size, void** buf)
+{
+    return timed_filter(SLOT, flags, cd_nelmts, cd_values, nbytes, buf_size, buf);
+}
+
+static const H5Z_func_t timed_filters[H5ZioFilterTimer::MAX_FILTERS] = {
+    timed_filter<0>, timed_filter<1>, timed_filter<2>, timed_filter<3>,
+    timed_filter<4>, timed_filter<5>, timed_filter<6>, timed_filter<7>
+};
+
+static int find_slot(H5Z_filter_t filter)
+{
+    for(int i = 0; i < filter_count; i++)
+    {
+        if(original_filters[i].id == filter)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool H5ZioFilterTimer::register_class(const H5Z_class2_t& filter_class)
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    if(find_slot(filter_class.id) >= 0)
+    {
+        return true;
+    }
+    if(filter_count == MAX_FILTERS)
+    {
+        return false;
+    }
+    original_filters[filter_count] = filter_class;
+    installed[filter_count]        = false;
+    filter_count++;
+    return true;
+}
+
+bool H5ZioFilterTimer::install(H5Z_filter_t filter)
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    int slot = find_slot(filter);
+    if(slot < 0 || filter_users == 0)
+    {
+        return false;
+    }
+    if(installed[slot])
+    {
+        return true;
+    }
+    // a classe é registrada de novo com a função medida: H5Zregister substitui a entrada do filtro
+    H5Z_class2_t timed = original_filters[slot];
+    timed.filter = timed_filters[slot];
+    installed[slot] = H5Zregister(&timed) >= 0;
+    return installed[slot];
+}
+
+void H5ZioFilterTimer::install(hid_t dataset_id)
+{
+    hid_t dcpl     = H5Dget_create_plist(dataset_id);
+    int   nfilters = H5Pget_nfilters(dcpl);
+    for(int i = 0; i < nfilters; i++)
+    {
+        unsigned int flags;
+        size_t       cd_nelmts = 0;
+        H5Z_filter_t filter    = H5Pget_filter2(dcpl, i, &flags, &cd_nelmts, NULL, 0, NULL, NULL);
+        install(filter);
+    }
+    H5Pclose(dcpl);
+}
+
+// restaura as classes originais (filter_mutex travado)
+static void uninstall_filters()
+{
+    for(int i = 0; i < filter_count; i++)
+    {
+        if(installed[i])
+        {
+            H5Zregister(&original_filters[i]);
+            installed[i] = false;
+        }
+    }
+}
+
+void H5ZioFilterTimer::uninstall()
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    uninstall_filters();
+}
+
+void H5ZioFilterTimer::enable()
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    filter_users++;
+}
+
+void H5ZioFilterTimer::disable()
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    if(filter_users > 0 && --filter_users == 0)
+    {
+        uninstall_filters();
+    }
+}
+
+bool H5ZioFilterTimer::is_installed(H5Z_filter_t filter)
+{
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    int slot = find_slot(filter);
+    return slot >= 0 && installed[slot];
+}
+
+H5ZioDatasetStats* H5ZioFilterTimer::attach(H5ZioDatasetStats* record)
+{
+    H5ZioDatasetStats* previous = current_record;
+    current_record = record;
+    return previous;
+}
+
+H5ZioDatasetStats* H5ZioFilterTimer::current()
+{
+    return current_record;
+}
+
+void H5ZioFilterTimer::add_chunk(H5ZioDatasetStats* record, size_t input_bytes, size_t output_bytes, double seconds)
+{
+    record->filter_chunks++;
+    record->filter_input_bytes  += input_bytes;
+    record->filter_output_bytes += output_bytes;
+    record->filter_seconds      += seconds;
+    record->max_chunk_seconds    = std::max(record->max_chunk_seconds, seconds);
+}
@@ -0,0 +1,390 @@
+#include "h5zio_intpack.h"
+#include "h5zio_filter_timer.h"
+
+#include <cstring>
+#include <cstdint>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+static const unsigned char INTPACK_VERSION = 1;
+static const unsigned char MODE_REFERENCE  = 0;
+static const unsigned char MODE_DELTA      = 1;
+static const size_t        BLOCK_HEADER    = 10;
+static const size_t        LANES           = H5ZIO::INTPACK_LANES;
+static const size_t        BLOCK           = H5ZIO::INTPACK_BLOCK;
+static const size_t        ROWS            = BLOCK / LANES;
+
+static unsigned char byte_order()
+{
+    uint16_t      one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first;
+}
+
+static int bit_width(uint64_t x)
+{
+    return x == 0 ? 0 : 64 - __builtin_clzll(x);
+}
+
+static uint64_t zigzag(uint64_t d)
+{
+    return (d << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(d) >> 63);
+}
+
+static uint64_t unzigzag(uint64_t z)
+{
+    return (z >> 1) ^ (0 - (z & 1));
+}
+
+// Empacota BLOCK resíduos de bits bits: o valor k*LANES + l fica na faixa l,
+// na posição k*bits do fluxo da faixa (palavras intercaladas entre as faixas).
+// words tem uma linha de LANES palavras além de bits * LANES: a parte alta de
+// um valor é sempre escrita na linha seguinte, sem desvio no laço das faixas
+// ((x >> 1) >> (63 - offset) é x >> (64 - offset), ou 0 com offset 0, e é 0
+// quando o valor cabe na palavra, pois x < 2^bits)
+static void pack(const uint64_t* u, int bits, uint64_t* words)
+{
+    std::fill(words, words + (bits + 1) * LANES, 0);
+    if(bits == 0)
+    {
+        return;
+    }
+    for(size_t k = 0; k < ROWS; k++)
+    {
+        size_t          position = k * bits;
+        size_t          offset   = position & 63;
+        const uint64_t* in       = u + k * LANES;
+        uint64_t*       low      = words + (position >> 6) * LANES;
+        uint64_t*       high     = low + LANES;
+        #pragma omp simd
+        for(size_t l = 0; l < LANES; l++)
+        {
+            low[l]  |= in[l] << offset;
+            high[l] |= (in[l] >> 1) >> (63 - offset);
+        }
+    }
+}
+
+// words com bits * LANES palavras e uma linha a mais, cujo conteúdo é descartado pela máscara
+static void unpack(const uint64_t* words, int bits, uint64_t* u)
+{
+    if(bits == 0)
+    {
+        std::fill(u, u + BLOCK, 0);
+        return;
+    }
+    uint64_t mask = bits == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << bits) - 1;
+    for(size_t k = 0; k < ROWS; k++)
+    {
+        size_t          position = k * bits;
+        size_t          offset   = position & 63;
+        const uint64_t* low      = words + (position >> 6) * LANES;
+        const uint64_t* high     = low + LANES;
+        uint64_t*       out      = u + k * LANES;
+        #pragma omp simd
+        for(size_t l = 0; l < LANES; l++)
+        {
+            out[l] = ((low[l] >> offset) | ((high[l] << 1) << (63 - offset))) & mask;
+        }
+    }
+}
+
+// valores estendidos para 64 bits: com sinal para tipos com sinal
+template <typename T>
+static uint64_t widen(T value)
+{
+    typedef typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type wide;
+    return static_cast<uint64_t>(static_cast<wide>(value));
+}
+
+template <typename T>
+static bool is_less(uint64_t a, uint64_t b)
+{
+    return std::is_signed<T>::value ? static_cast<int64_t>(a) < static_cast<int64_t>(b) : a < b;
+}
+
+// Codifica um bloco: escolhe entre referência e delta pela menor largura
+template <typename T>
+static void encode_block(const uint64_t* v, uint64_t previous, std::vector<unsigned char>& out)
+{
+    uint64_t z[BLOCK], u[BLOCK], words[65 * LANES];
+
+    z[0] = zigzag(v[0] - previous);
+    for(size_t i = 1; i < BLOCK; i++)
+    {
+        z[i] = zigzag(v[i] - v[i-1]);
+    }
+    uint64_t min_v = v[0], min_z = z[0];
+    for(size_t i = 1; i < BLOCK; i++)
+    {
+        min_v = is_less<T>(v[i], min_v) ? v[i] : min_v;
+        min_z = z[i] < min_z ? z[i] : min_z;
+    }
+    uint64_t spread_v = 0, spread_z = 0;
+    for(size_t i = 0; i < BLOCK; i++)
+    {
+        spread_v |= v[i] - min_v;
+        spread_z |= z[i] - min_z;
+    }
+
+    // empate: referência, que decodifica sem a soma prefixada
+    int           bits_v    = bit_width(spread_v), bits_z = bit_width(spread_z);
+    unsigned char mode      = bits_z < bits_v ? MODE_DELTA : MODE_REFERENCE;
+    int           bits      = mode == MODE_DELTA ? bits_z : bits_v;
+    uint64_t      reference = mode == MODE_DELTA ? min_z : min_v;
+    const uint64_t* source  = mode == MODE_DELTA ? z : v;
+    for(size_t i = 0; i < BLOCK; i++)
+    {
+        u[i] = source[i] - reference;
+    }
+    pack(u, bits, words);
+
+    size_t position = out.size();
+    out.resize(position + BLOCK_HEADER + bits * LANES * sizeof(uint64_t));
+    out[position]     = mode;
+    out[position + 1] = static_cast<unsigned char>(bits);
+    std::memcpy(&out[position + 2], &reference, sizeof(uint64_t));
+    std::memcpy(&out[position + BLOCK_HEADER], words, bits * LANES * sizeof(uint64_t));
+}
+
+template <typename T>
+static void encode_values(const void* data, size_t count, std::vector<unsigned char>& out)
+{
+    const T* values = static_cast<const T*>(data);
+    size_t   nblocks = (count + BLOCK - 1) / BLOCK;
+
+    out.clear();
+    out.reserve(H5ZIO::INTPACK_HEADER + count * sizeof(T) + nblocks * BLOCK_HEADER);
+    out.resize(H5ZIO::INTPACK_HEADER, 0);
+    out[0] = INTPACK_VERSION;
+    out[1] = sizeof(T);
+    out[2] = std::is_signed<T>::value;
+    out[3] = byte_order();
+    uint64_t n = count;
+    std::memcpy(&out[8], &n, sizeof(uint64_t));
+
+    // o último bloco é completado com o último valor (delta zero)
+    uint64_t v[BLOCK];
+    uint64_t previous = 0;
+    for(size_t b = 0; b < nblocks; b++)
+    {
+        size_t first = b * BLOCK;
+        size_t valid = std::min(BLOCK, count - first);
+        for(size_t i = 0; i < valid; i++)
+        {
+            v[i] = widen(values[first + i]);
+        }
+        std::fill(v + valid, v + BLOCK, v[valid - 1]);
+        encode_block<T>(v, previous, out);
+        previous = v[BLOCK - 1];
+    }
+}
+
+template <typename T>
+static void decode_values(const unsigned char* in, size_t in_size, size_t count, void* data)
+{
+    T*       values = static_cast<T*>(data);
+    size_t   nblocks = (count + BLOCK - 1) / BLOCK;
+    uint64_t u[BLOCK], words[65 * LANES];
+    uint64_t previous = 0;
+    size_t   position = 0;
+    for(size_t b = 0; b < nblocks; b++)
+    {
+        if(position + BLOCK_HEADER > in_size)
+        {
+            throw std::runtime_error("Truncated intpack chunk");
+        }
+        unsigned char mode = in[position];
+        int           bits = in[position + 1];
+        uint64_t      reference;
+        std::memcpy(&reference, in + position + 2, sizeof(uint64_t));
+        size_t nbytes = bits * LANES * sizeof(uint64_t);
+        if(bits > 64 || mode > MODE_DELTA || position + BLOCK_HEADER + nbytes > in_size)
+        {
+            throw std::runtime_error("Invalid intpack chunk");
+        }
+        std::memcpy(words, in + position + BLOCK_HEADER, nbytes);
+        std::fill(words + bits * LANES, words + (bits + 1) * LANES, 0);
+        position += BLOCK_HEADER + nbytes;
+        unpack(words, bits, u);
+
+        if(mode == MODE_REFERENCE)
+        {
+            for(size_t i = 0; i < BLOCK; i++)
+            {
+                u[i] += reference;
+            }
+        }
+        else
+        {
+            for(size_t i = 0; i < BLOCK; i++)
+            {
+                previous += unzigzag(u[i] + reference);
+                u[i] = previous;
+            }
+        }
+        previous = u[BLOCK - 1];
+
+        size_t first = b * BLOCK;
+        size_t valid = std::min(BLOCK, count - first);
+        for(size_t i = 0; i < valid; i++)
+        {
+            values[first + i] = static_cast<T>(u[i]);
+        }
+    }
+}
+
+// chama f com um valor do tipo inteiro de tamanho e sinal informados
+template <typename F>
+static void dispatch(size_t element_size, bool is_signed, F f)
+{
+    switch(element_size)
+    {
+        case 1: if(is_signed) f(int8_t());  else f(uint8_t());  return;
+        case 2: if(is_signed) f(int16_t()); else f(uint16_t()); return;
+        case 4: if(is_signed) f(int32_t()); else f(uint32_t()); return;
+        case 8: if(is_signed) f(int64_t()); else f(uint64_t()); return;
+    }
+    throw std::runtime_error("Unsupported integer size for intpack");
+}
+
+// Callbacks do filtro HDF5
+static htri_t intpack_can_apply(hid_t, hid_t type_id, hid_t)
+{
+    size_t size = H5Tget_size(type_id);
+    return H5Tget_class(type_id) == H5T_INTEGER && (size == 1 || size == 2 || size == 4 || size == 8);
+}
+
+// cd_values: versão, tamanho do elemento e sinal
+static herr_t intpack_set_local(hid_t dcpl_id, hid_t type_id, hid_t)
+{
+    unsigned int flags;
+    size_t       cd_nelmts = 0;
+    if(H5Pget_filter_by_id2(dcpl_id, H5ZIO::FILTER_INTPACK, &flags, &cd_nelmts, NULL, 0, NULL, NULL) < 0)
+    {
+        return -1;
+    }
+    unsigned int cd_values[3] = {INTPACK_VERSION, static_cast<unsigned int>(H5Tget_size(type_id)),
+                                 H5Tget_sign(type_id) == H5T_SGN_2 ? 1u : 0u};
+    return H5Pmodify_filter(dcpl_id, H5ZIO::FILTER_INTPACK, flags, 3, cd_values);
+}
+
+static size_t intpack_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes,
+                      size_t* buf_size, void** buf)
+{
+    try
+    {
+        if(flags & H5Z_FLAG_REVERSE)
+        {
+            size_t size = H5ZIO::intpack_decoded_size(*buf, nbytes);
+            void*  out  = H5allocate_memory(std::max<size_t>(size, 1), false);
+            if(out == NULL)
+            {
+                return 0;
+            }
+            try
+            {
+                H5ZIO::intpack_decode(*buf, nbytes, out, size);
+            }
+            catch(...)
+            {
+                H5free_memory(out);
+                throw;
+            }
+            H5free_memory(*buf);
+            *buf      = out;
+            *buf_size = size;
+            return size;
+        }
+
+        if(cd_nelmts < 3 || cd_values[1] == 0)
+        {
+            return 0;
+        }
+        std::vector<unsigned char> encoded;
+        H5ZIO::intpack_encode(*buf, nbytes / cd_values[1], cd_values[1], cd_values[2] != 0, encoded);
+        // sem ganho: o filtro é opcional e o HDF5 grava o chunk sem ele
+        if(encoded.size() >= nbytes)
+        {
+            return 0;
+        }
+        std::memcpy(*buf, encoded.data(), encoded.size());
+        return encoded.size();
+    }
+    catch(...)
+    {
+        return 0;
+    }
+}
+
+namespace H5ZIO {
+
+bool register_intpack()
+{
+    static std::once_flag once;
+    static bool           registered = false;
+    std::call_once(once, []() {
+        H5Z_class2_t filter_class = {H5Z_CLASS_T_VERS, FILTER_INTPACK, 1, 1, "h5zio intpack",
+                                     intpack_can_apply, intpack_set_local, intpack_filter};
+        registered = H5Zregister(&filter_class) >= 0;
+        if(registered)
+        {
+            H5ZioFilterTimer::register_class(filter_class);
+        }
+    });
+    return registered;
+}
+
+void intpack_encode(const void* data, size_t count, size_t element_size, bool is_signed, std::vector<unsigned char>& out)
+{
+    dispatch(element_size, is_signed, [&](auto value) {
+        encode_values<decltype(value)>(data, count, out);
+    });
+}
+
+size_t intpack_decoded_size(const void* in, size_t in_size)
+{
+    const unsigned char* header = static_cast<const unsigned char*>(in);
+    if(in_size < INTPACK_HEADER || header[0] != INTPACK_VERSION || header[2] > 1)
+    {
+        throw std::runtime_error("Invalid intpack chunk");
+    }
+    size_t element_size = header[1];
+    if(element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8)
+    {
+        throw std::runtime_error("Invalid intpack chunk");
+    }
+    if(header[3] != byte_order())
+    {
+        throw std::runtime_error("Intpack chunk written with a different byte order");
+    }
+    // cada bloco ocupa ao menos o seu cabeçalho: limita o número de elementos (e a alocação)
+    uint64_t count;
+    std::memcpy(&count, header + 8, sizeof(uint64_t));
+    uint64_t nblocks = count / BLOCK + (count % BLOCK != 0);
+    if(nblocks > (in_size - INTPACK_HEADER) / BLOCK_HEADER)
+    {
+        throw std::runtime_error("Truncated intpack chunk");
+    }
+    return count * element_size;
+}
+
+size_t intpack_decode(const void* in, size_t in_size, void* data, size_t capacity)
+{
+    size_t size = intpack_decoded_size(in, in_size);
+    if(size > capacity)
+    {
+        throw std::runtime_error("Intpack chunk is larger than the output buffer");
+    }
+    const unsigned char* header = static_cast<const unsigned char*>(in);
+    size_t count = size / header[1];
+    dispatch(header[1], header[2] != 0, [&](auto value) {
+        decode_values<decltype(value)>(header + INTPACK_HEADER, in_size - INTPACK_HEADER, count, data);
+    });
+    return size;
+}
+
+}
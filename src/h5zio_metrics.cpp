@@ -0,0 +1,100 @@
+#include "h5zio_metrics.h"
+
+#include <limits>
+
+const size_t H5ZioMetrics::BLOCK_SIZE;
+
+H5ZioMetrics::H5ZioMetrics()
+{
+    reset();
+}
+
+void H5ZioMetrics::reset()
+{
+    count             = 0;
+    minimum           = 0.0;
+    maximum           = 0.0;
+    max_abs_error     = 0.0;
+    max_rel_error     = 0.0;
+    sum_squared_error = 0.0;
+    mean_x            = 0.0;
+    mean_y            = 0.0;
+    m2x               = 0.0;
+    m2y               = 0.0;
+    cxy               = 0.0;
+}
+
+void H5ZioMetrics::merge(const H5ZioMetrics& other)
+{
+    add(other.count, other.minimum, other.maximum, other.max_abs_error, other.max_rel_error,
+        other.sum_squared_error, other.mean_x, other.mean_y, other.m2x, other.m2y, other.cxy);
+}
+
+void H5ZioMetrics::add(size_t n, double n_minimum, double n_maximum, double n_max_abs_error, double n_max_rel_error,
+                       double n_sum_squared_error, double n_mean_x, double n_mean_y, double n_m2x, double n_m2y, double n_cxy)
+{
+    if(n == 0)
+    {
+        return;
+    }
+    if(count == 0)
+    {
+        count             = n;
+        minimum           = n_minimum;
+        maximum           = n_maximum;
+        max_abs_error     = n_max_abs_error;
+        max_rel_error     = n_max_rel_error;
+        sum_squared_error = n_sum_squared_error;
+        mean_x            = n_mean_x;
+        mean_y            = n_mean_y;
+        m2x               = n_m2x;
+        m2y               = n_m2y;
+        cxy               = n_cxy;
+        return;
+    }
+
+    // Chan, Golub e LeVeque: combinação de médias e momentos centrados
+    double total   = static_cast<double>(count + n);
+    double weight  = static_cast<double>(count) * n / total;
+    double delta_x = n_mean_x - mean_x;
+    double delta_y = n_mean_y - mean_y;
+
+    mean_x += delta_x * n / total;
+    mean_y += delta_y * n / total;
+    m2x    += n_m2x + delta_x * delta_x * weight;
+    m2y    += n_m2y + delta_y * delta_y * weight;
+    cxy    += n_cxy + delta_x * delta_y * weight;
+
+    count             += n;
+    minimum            = std::min(minimum, n_minimum);
+    maximum            = std::max(maximum, n_maximum);
+    max_abs_error      = std::max(max_abs_error, n_max_abs_error);
+    max_rel_error      = std::max(max_rel_error, n_max_rel_error);
+    sum_squared_error += n_sum_squared_error;
+}
+
+double H5ZioMetrics::get_nrmse() const
+{
+    double range = get_range();
+    return range > 0.0 ? get_rmse() / range : 0.0;
+}
+
+double H5ZioMetrics::get_psnr() const
+{
+    double mse = get_mse();
+    if(mse == 0.0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 20.0 * std::log10(get_range()) - 10.0 * std::log10(mse);
+}
+
+double H5ZioMetrics::get_pearson() const
+{
+    // arrays constantes: correlação 1 apenas se a reconstrução for exata
+    if(m2x == 0.0 || m2y == 0.0)
+    {
+        return sum_squared_error == 0.0 ? 1.0 : 0.0;
+    }
+    return cxy / std::sqrt(m2x * m2y);
+}
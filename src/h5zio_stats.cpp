@@ -0,0 +1,162 @@
+#include "h5zio_stats.h"
+
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+void H5ZioDatasetStats::merge(const H5ZioDatasetStats& other)
+{
+    calls               += other.calls;
+    raw_bytes           += other.raw_bytes;
+    stored_bytes        += other.stored_bytes;
+    wall_seconds        += other.wall_seconds;
+    setup_seconds       += other.setup_seconds;
+    io_seconds          += other.io_seconds;
+    compression_seconds += other.compression_seconds;
+    metadata_seconds    += other.metadata_seconds;
+    peak_buffer_bytes    = std::max(peak_buffer_bytes, other.peak_buffer_bytes);
+    filter_chunks       += other.filter_chunks;
+    filter_input_bytes  += other.filter_input_bytes;
+    filter_output_bytes += other.filter_output_bytes;
+    filter_seconds      += other.filter_seconds;
+    max_chunk_seconds    = std::max(max_chunk_seconds, other.max_chunk_seconds);
+}
+
+void H5ZioStats::add(const H5ZioDatasetStats& stats)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_pair(stats.dataset, stats.operation);
+    auto it  = index.find(key);
+    if(it == index.end())
+    {
+        index[key] = records.size();
+        records.push_back(stats);
+        return;
+    }
+    records[it->second].merge(stats);
+}
+
+std::vector<H5ZioDatasetStats> H5ZioStats::get_datasets()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+H5ZioDatasetStats H5ZioStats::get_dataset(const std::string& dataset, const std::string& operation)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(std::make_pair(dataset, operation));
+    if(it == index.end())
+    {
+        H5ZioDatasetStats empty;
+        empty.dataset   = dataset;
+        empty.operation = operation;
+        return empty;
+    }
+    return records[it->second];
+}
+
+H5ZioDatasetStats H5ZioStats::get_total(const std::string& operation)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    H5ZioDatasetStats total;
+    total.dataset   = "total";
+    total.operation = operation;
+    for(auto& record : records)
+    {
+        if(record.operation == operation)
+        {
+            total.merge(record);
+        }
+    }
+    return total;
+}
+
+size_t H5ZioStats::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return records.size();
+}
+
+void H5ZioStats::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    records.clear();
+    index.clear();
+}
+
+namespace H5ZIO {
+
+std::string json_number(double value)
+{
+    if(!std::isfinite(value)) return "null";
+    std::ostringstream ss;
+    ss.precision(10);
+    ss << value;
+    return ss.str();
+}
+
+}
+
+static std::string json_string(const std::string& value)
+{
+    std::string escaped = "\"";
+    for(char c : value)
+    {
+        if(c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+void H5ZioStats::write_json(std::ostream& out)
+{
+    std::vector<H5ZioDatasetStats> snapshot = get_datasets();
+    out << "[" << std::endl;
+    for(size_t i = 0; i < snapshot.size(); i++)
+    {
+        H5ZioDatasetStats& r = snapshot[i];
+        out << "  {\"dataset\": " << json_string(r.dataset) << ", \"operation\": " << json_string(r.operation)
+            << ", \"calls\": " << r.calls << ", \"raw_bytes\": " << r.raw_bytes << ", \"stored_bytes\": " << r.stored_bytes
+            << ", \"ratio\": " << H5ZIO::json_number(r.get_ratio()) << ", \"wall_seconds\": " << H5ZIO::json_number(r.wall_seconds)
+            << ", \"setup_seconds\": " << H5ZIO::json_number(r.setup_seconds) << ", \"io_seconds\": " << H5ZIO::json_number(r.io_seconds)
+            << ", \"compression_seconds\": " << H5ZIO::json_number(r.compression_seconds)
+            << ", \"metadata_seconds\": " << H5ZIO::json_number(r.metadata_seconds)
+            << ", \"peak_buffer_bytes\": " << r.peak_buffer_bytes << ", \"filter_chunks\": " << r.filter_chunks
+            << ", \"filter_input_bytes\": " << r.filter_input_bytes << ", \"filter_output_bytes\": " << r.filter_output_bytes
+            << ", \"filter_seconds\": " << H5ZIO::json_number(r.filter_seconds)
+            << ", \"max_chunk_seconds\": " << H5ZIO::json_number(r.max_chunk_seconds) << "}" << (i + 1 < snapshot.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+void H5ZioStats::write_csv(std::ostream& out)
+{
+    std::vector<H5ZioDatasetStats> snapshot = get_datasets();
+    out << "dataset,operation,calls,raw_bytes,stored_bytes,ratio,wall_seconds,setup_seconds,io_seconds,"
+        << "compression_seconds,metadata_seconds,peak_buffer_bytes,filter_chunks,filter_input_bytes,filter_output_bytes,"
+        << "filter_seconds,max_chunk_seconds" << std::endl;
+    std::streamsize precision = out.precision(10);
+    for(auto& r : snapshot)
+    {
+        out << r.dataset << "," << r.operation << "," << r.calls << "," << r.raw_bytes << "," << r.stored_bytes << ","
+            << r.get_ratio() << "," << r.wall_seconds << "," << r.setup_seconds << "," << r.io_seconds << ","
+            << r.compression_seconds << "," << r.metadata_seconds << "," << r.peak_buffer_bytes << "," << r.filter_chunks << ","
+            << r.filter_input_bytes << "," << r.filter_output_bytes << "," << r.filter_seconds << "," << r.max_chunk_seconds << std::endl;
+    }
+    out.precision(precision);
+}
+
+void H5ZioStats::save(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if(!out)
+    {
+        throw std::runtime_error("Failed to open statistics file " + filename);
+    }
+    bool json = filename.size() > 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+    if(json) write_json(out);
+    else     write_csv(out);
+}
@@ -0,0 +1,134 @@
+#include "h5zio_trace.h"
+
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+const size_t H5ZioTrace::DEFAULT_CAPACITY;
+
+std::atomic<bool>                   H5ZioTrace::enabled(false);
+std::atomic<uint64_t>               H5ZioTrace::head(0);
+std::unique_ptr<H5ZioTrace::event[]> H5ZioTrace::events;
+size_t                              H5ZioTrace::capacity = 0;
+
+static std::atomic<int64_t>  trace_epoch(0);
+static std::atomic<uint32_t> trace_threads(0);
+
+static int64_t steady_nanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// identificador curto por thread, na ordem do primeiro evento
+static uint32_t thread_index()
+{
+    thread_local uint32_t index = trace_threads.fetch_add(1) + 1;
+    return index;
+}
+
+void H5ZioTrace::enable(size_t requested)
+{
+    size_t size = 1;
+    while(size < requested) size <<= 1;
+
+    enabled.store(false);
+    if(!events || size != capacity)
+    {
+        events.reset(new event[size]);
+        capacity = size;
+    }
+    for(size_t i = 0; i < capacity; i++)
+    {
+        events[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    head.store(0);
+    trace_epoch.store(steady_nanoseconds());
+    enabled.store(true);
+}
+
+void H5ZioTrace::disable()
+{
+    enabled.store(false);
+}
+
+int64_t H5ZioTrace::now()
+{
+    return steady_nanoseconds() - trace_epoch.load(std::memory_order_relaxed);
+}
+
+void H5ZioTrace::record(const char* name, int64_t begin, int64_t end)
+{
+    if(!events)
+    {
+        return;
+    }
+    // seqlock por posição: quem lê descarta eventos em escrita ou sobrescritos
+    uint64_t position = head.fetch_add(1, std::memory_order_relaxed);
+    event&   e        = events[position & (capacity - 1)];
+    e.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name   = name;
+    e.thread = thread_index();
+    e.begin  = begin;
+    e.end    = end;
+    e.sequence.store(position + 1, std::memory_order_release);
+}
+
+size_t H5ZioTrace::recorded()
+{
+    return head.load();
+}
+
+void H5ZioTrace::write_json(std::ostream& out)
+{
+    struct snapshot
+    {
+        const char* name;
+        uint32_t    thread;
+        int64_t     begin;
+        int64_t     end;
+    };
+    std::vector<snapshot> snapshots;
+    if(events)
+    {
+        uint64_t last  = head.load(std::memory_order_acquire);
+        uint64_t first = last > capacity ? last - capacity : 0;
+        for(uint64_t position = first; position < last; position++)
+        {
+            event&   e        = events[position & (capacity - 1)];
+            uint64_t sequence = e.sequence.load(std::memory_order_acquire);
+            snapshot s        = {e.name, e.thread, e.begin, e.end};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(sequence == position + 1 && e.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                snapshots.push_back(s);
+            }
+        }
+    }
+
+    // eventos completos ("X"), com tempos em microssegundos
+    out << "{\"traceEvents\": [" << std::endl;
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    for(size_t i = 0; i < snapshots.size(); i++)
+    {
+        snapshot& s = snapshots[i];
+        out << "  {\"name\": \"" << s.name << "\", \"cat\": \"h5zio\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << s.thread
+            << ", \"ts\": " << s.begin / 1000.0 << ", \"dur\": " << (s.end - s.begin) / 1000.0 << "}"
+            << (i + 1 < snapshots.size() ? "," : "") << std::endl;
+    }
+    out.flags(flags);
+    out << "], \"displayTimeUnit\": \"ms\"}" << std::endl;
+}
+
+void H5ZioTrace::save(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if(!out)
+    {
+        throw std::runtime_error("Failed to open trace file " + filename);
+    }
+    write_json(out);
+}
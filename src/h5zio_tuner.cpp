@@ -0,0 +1,247 @@
+#include "h5zio_tuner.h"
+
+#include <algorithm>
+
+H5ZioTuner::H5ZioTuner()
+{
+    tolerance       = 0.05;
+    max_iterations  = 8;
+    sample_fraction = 0.02;
+    max_sample_size = 4194304;
+
+    bound      = 0.0;
+    ratio      = 0.0;
+    psnr       = 0.0;
+    throughput = 0.0;
+    iterations = 0;
+    best_error = 0.0;
+    best_safe  = false;
+}
+
+void H5ZioTuner::set_tolerance(double tolerance)
+{
+    if(tolerance <= 0)
+    {
+        throw std::runtime_error("Tolerance must be positive");
+    }
+    this->tolerance = tolerance;
+}
+
+void H5ZioTuner::set_max_iterations(int iterations)
+{
+    if(iterations < 1)
+    {
+        throw std::runtime_error("Number of iterations must be positive");
+    }
+    max_iterations = iterations;
+}
+
+void H5ZioTuner::set_sample_fraction(double fraction)
+{
+    if(fraction <= 0 || fraction > 1)
+    {
+        throw std::runtime_error("Sample fraction must be in (0, 1]");
+    }
+    sample_fraction = fraction;
+}
+
+void H5ZioTuner::set_max_sample_size(hsize_t bytes)
+{
+    max_sample_size = bytes;
+}
+
+void H5ZioTuner::plan_sample(H5ZIOParameters& parameters, hsize_t ndims, const hsize_t dims[], size_t type_size,
+                             std::vector<hsize_t>& block, std::vector<std::vector<hsize_t> >& offsets)
+{
+    if(ndims == 0)
+    {
+        throw std::runtime_error("Tuning requires at least one dimension");
+    }
+
+    hsize_t total = type_size;
+    for(hsize_t i = 0; i < ndims; i++)
+    {
+        total *= dims[i];
+    }
+
+    // amostra: fração do array, com no mínimo 256 KB e no máximo max_sample_size
+    const hsize_t nblocks = 8;
+    hsize_t sample_bytes = static_cast<hsize_t>(sample_fraction * total);
+    sample_bytes = std::max<hsize_t>(sample_bytes, 262144);
+    sample_bytes = std::min<hsize_t>(sample_bytes, max_sample_size);
+
+    block.resize(ndims);
+    offsets.clear();
+    if(sample_bytes >= total)
+    {
+        // array pequeno: a amostra é o próprio array
+        block.assign(dims, dims + ndims);
+        offsets.push_back(std::vector<hsize_t>(ndims, 0));
+        return;
+    }
+
+    // blocos com o formato que o planejador de chunks usaria (múltiplos do bloco do compressor)
+    H5ZIOParameters planner(parameters);
+    planner.set_chunk_size(std::max<hsize_t>(sample_bytes / nblocks, type_size));
+    planner.plan_chunk_dimensions(ndims, dims, type_size, block.data());
+
+    // posições espalhadas: passos ímpares diferentes em cada dimensão
+    for(hsize_t k = 0; k < nblocks; k++)
+    {
+        std::vector<hsize_t> offset(ndims);
+        for(hsize_t i = 0; i < ndims; i++)
+        {
+            hsize_t span = dims[i] - block[i];
+            hsize_t slot = (k * (2 * i + 1)) % nblocks;
+            offset[i]    = span * slot / (nblocks - 1);
+        }
+        offsets.push_back(offset);
+    }
+}
+
+std::vector<H5ZIOParameters> H5ZioTuner::codec_candidates(H5ZIOParameters& parameters, double range, double& absolute_bound)
+{
+    // limite absoluto comum aos compressores com perdas
+    absolute_bound = 0.0;
+#if defined(H5ZIO_HAS_ZFP) || defined(H5ZIO_HAS_SZ)
+    // o valor é guardado por tipo de erro; o compressor de parameters pode ser AUTO
+    H5ZIOParameters lossy(parameters);
+    lossy.set_compression_type(parameters.get_error_bound_type() >= static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY) ?
+                               H5ZIO::Type::ZFP : H5ZIO::Type::SZ2);
+    double value = lossy.get_error_bound_value();
+    switch(parameters.get_error_bound_type())
+    {
+        case static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY):
+        case static_cast<int>(H5ZIO::SZ2::ErrorBound::ABSOLUTE):
+            absolute_bound = value;
+            break;
+        case static_cast<int>(H5ZIO::SZ2::ErrorBound::RELATIVE):
+            absolute_bound = value * range;
+            break;
+        case static_cast<int>(H5ZIO::SZ2::ErrorBound::ABS_AND_REL):
+            absolute_bound = std::min(value, value * range);
+            break;
+        case static_cast<int>(H5ZIO::SZ2::ErrorBound::ABS_OR_REL):
+            absolute_bound = std::max(value, value * range);
+            break;
+        case static_cast<int>(H5ZIO::ZFP::ErrorBound::REVERSIBLE):
+            absolute_bound = 0.0;
+            break;
+        default:
+            throw std::runtime_error("Codec selection requires an absolute, relative or reversible error bound");
+    }
+#endif
+
+    std::vector<H5ZIOParameters> candidates;
+#ifdef H5ZIO_HAS_ZFP
+    {
+        H5ZIOParameters zfp(parameters);
+        zfp.set_compression_type(H5ZIO::Type::ZFP);
+        if(absolute_bound > 0)
+        {
+            zfp.set_error_bound_type(H5ZIO::ZFP::ErrorBound::ACCURACY);
+            zfp.set_error_bound_value(absolute_bound);
+        }
+        else
+        {
+            zfp.set_error_bound_type(H5ZIO::ZFP::ErrorBound::REVERSIBLE);
+        }
+        candidates.push_back(zfp);
+    }
+#endif
+#ifdef H5ZIO_HAS_SZ
+    // o SZ não tem modo sem perdas
+    if(absolute_bound > 0)
+    {
+        H5ZIOParameters sz(parameters);
+        sz.set_compression_type(H5ZIO::Type::SZ2);
+        sz.set_error_bound_type(H5ZIO::SZ2::ErrorBound::ABSOLUTE);
+        sz.set_error_bound_value(absolute_bound);
+        candidates.push_back(sz);
+    }
+#endif
+#ifdef H5ZIO_HAS_GZIP
+    {
+        H5ZIOParameters gzip(parameters);
+        gzip.set_compression_type(H5ZIO::Type::GZIP);
+        candidates.push_back(gzip);
+    }
+#endif
+    return candidates;
+}
+
+double H5ZioTuner::encode_seconds(H5ZioChunkCodec& codec, const void* sample, size_t type_size, std::vector<hsize_t>& sample_dims)
+{
+    hsize_t ndims = sample_dims.size();
+    H5ZioChunkGrid grid(ndims, sample_dims.data(), codec.get_chunk_dims());
+
+    // chunks copiados (com zeros na borda) antes da medida
+    std::vector<unsigned char> chunk(codec.get_chunk_bytes()), out;
+    std::vector<hsize_t> offset(ndims), count(ndims), start(ndims, 0);
+    double seconds = 0.0;
+    for(hsize_t c = 0; c < grid.size(); c++)
+    {
+        grid.chunk(c, offset.data(), count.data());
+        std::fill(chunk.begin(), chunk.end(), 0);
+        H5ZIO::copy_box(ndims, type_size, count.data(), sample, sample_dims.data(), offset.data(),
+                        chunk.data(), codec.get_chunk_dims(), start.data());
+
+        auto begin = std::chrono::steady_clock::now();
+        codec.encode(chunk.data(), out);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+    return seconds;
+}
+
+void H5ZioTuner::search_interval(H5ZIOParameters& parameters, double range, double& lower, double& upper, bool& logarithmic)
+{
+    logarithmic = true;
+    if(parameters.get_compression_type() == H5ZIO::Type::ZFP)
+    {
+        if(parameters.get_error_bound_type() != static_cast<int>(H5ZIO::ZFP::ErrorBound::ACCURACY))
+        {
+            throw std::runtime_error("Error bound tuning requires ZFP accuracy mode");
+        }
+        lower = range * 1.0E-12;
+        upper = range;
+        return;
+    }
+    if(parameters.get_compression_type() == H5ZIO::Type::SZ2)
+    {
+        switch(static_cast<H5ZIO::SZ2::ErrorBound>(parameters.get_error_bound_type()))
+        {
+            case H5ZIO::SZ2::ErrorBound::ABSOLUTE:
+                lower = range * 1.0E-12;
+                upper = range;
+                return;
+            case H5ZIO::SZ2::ErrorBound::RELATIVE:
+            case H5ZIO::SZ2::ErrorBound::PW_RELATIVE:
+                lower = 1.0E-12;
+                upper = 1.0;
+                return;
+            case H5ZIO::SZ2::ErrorBound::SZ_PSNR:
+                // PSNR menor, maior compressão
+                logarithmic = false;
+                lower = 240.0;
+                upper = 1.0;
+                return;
+            default:
+                throw std::runtime_error("Error bound tuning does not support combined SZ error bounds");
+        }
+    }
+    throw std::runtime_error("Error bound tuning requires a lossy compressor (ZFP or SZ2)");
+}
+
+void H5ZioTuner::select(double x, double sample_ratio, double sample_psnr, double error, bool safe)
+{
+    bool hit    = error <= tolerance;
+    bool better = hit || (safe && (!best_safe || error < best_error)) || (!safe && !best_safe && error < best_error);
+    if(better)
+    {
+        bound      = x;
+        ratio      = sample_ratio;
+        psnr       = sample_psnr;
+        best_error = error;
+        best_safe  = safe;
+    }
+}
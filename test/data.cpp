@@ -3,6 +3,9 @@
 #include <vector>
 #include <cmath>
 
+#include "data.h"
+#include "h5zio.h"
+
 void build_grid_square(std::vector<double>& x, std::vector<double>& y, double xmin , double ymin, double xmax, double ymax, int nx, int ny)
 {
     x.resize(nx*ny);
@@ -55,3 +58,82 @@ double compute_infinity_norm(const std::vector<double>& a, const std::vector<dou
     return max;
 }
 
+
+// Compare the stored chunks of a dataset in two files
+static bool same_chunks(const std::string& file_a, const std::string& file_b, const std::string& dataset)
+{
+    hid_t files[2]    = {H5Fopen(file_a.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fopen(file_b.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT)};
+    hid_t datasets[2] = {H5Dopen(files[0], dataset.c_str(), H5P_DEFAULT), H5Dopen(files[1], dataset.c_str(), H5P_DEFAULT)};
+    hid_t spaces[2]   = {H5Dget_space(datasets[0]), H5Dget_space(datasets[1])};
+    hsize_t nchunks[2] = {0, 0};
+    H5Dget_num_chunks(datasets[0], spaces[0], &nchunks[0]);
+    H5Dget_num_chunks(datasets[1], spaces[1], &nchunks[1]);
+
+    bool same = nchunks[0] == nchunks[1] && nchunks[0] > 1;
+    for (hsize_t c = 0; same && c < nchunks[0]; c++)
+    {
+        std::vector<unsigned char> chunks[2];
+        unsigned int masks[2];
+        hsize_t offset[2][2];
+        for (int k = 0; k < 2; k++)
+        {
+            haddr_t address;
+            hsize_t size = 0;
+            H5Dget_chunk_info(datasets[k], spaces[k], c, offset[k], &masks[k], &address, &size);
+            chunks[k].resize(size);
+            H5Dread_chunk(datasets[k], H5P_DEFAULT, offset[k], &masks[k], chunks[k].data());
+        }
+        same = offset[0][0] == offset[1][0] && offset[0][1] == offset[1][1] && masks[0] == masks[1] && chunks[0] == chunks[1];
+        if (!same)
+        {
+            std::cout << "Chunk " << c << " differs between " << file_a << " and " << file_b << std::endl;
+        }
+    }
+    for (int k = 0; k < 2; k++)
+    {
+        H5Sclose(spaces[k]);
+        H5Dclose(datasets[k]);
+        H5Fclose(files[k]);
+    }
+    return same;
+}
+
+bool check_chunk_paths(const std::string& prefix, const std::vector<double>& f, int nx, int ny, H5ZIOParameters& parameters)
+{
+    hsize_t dims[2] = {(hsize_t) ny, (hsize_t) nx};
+    unsigned int threads[2] = {1, 4};
+    std::string filenames[2];
+    std::vector<double> reference;
+    bool passed = true;
+
+    for (int w = 0; w < 2; w++)
+    {
+        filenames[w] = prefix + "_" + std::to_string(threads[w]) + ".h5";
+        H5Zio writer;
+        writer.set_num_threads(threads[w]);
+        writer.open(filenames[w], "w");
+        writer.write_dataset<double>("f", f.data(), 2, dims, &parameters);
+        writer.close();
+
+        // 1 thread: H5Dread pelo filtro registrado; 4 threads: decodificação paralela
+        for (int r = 0; r < 2; r++)
+        {
+            std::vector<double> g;
+            H5Zio reader;
+            reader.set_num_threads(threads[r]);
+            reader.open(filenames[w], "r");
+            reader.read_dataset<double>("f", g);
+            reader.close();
+
+            if (reference.empty())
+            {
+                reference = g;
+            }
+            bool same = g.size() == f.size() && g == reference;
+            std::cout << "Written with " << threads[w] << " thread(s), read with " << threads[r] << " thread(s): "
+                      << (same ? "same" : "different") << std::endl;
+            passed = passed && same;
+        }
+    }
+    return same_chunks(filenames[0], filenames[1], "f") && passed;
+}
@@ -14,4 +14,11 @@ double compute_l2_norm(const std::vector<double>& a, const std::vector<double>&
 
 double compute_infinity_norm(const std::vector<double>& a, const std::vector<double>& b);
 
+class H5ZIOParameters;
+
+// Grava f (nx x ny) com 1 e com 4 threads e lê cada arquivo pelos dois caminhos: os chunks
+// codificados por H5ZioChunkCodec devem ser idênticos aos do filtro registrado, e os dados
+// lidos iguais aos da execução com 1 thread
+bool check_chunk_paths(const std::string& prefix, const std::vector<double>& f, int nx, int ny, H5ZIOParameters& parameters);
+
 #endif     /* DATA_H__ */
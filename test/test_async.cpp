@@ -0,0 +1,81 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <future>
+#include <cmath>
+
+#include "h5zio.h"
+
+int main()
+{
+    hsize_t dims[2] = {64, 48};
+    int nsteps = 6;
+
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::GZIP);
+
+    H5Zio h5zio;
+    h5zio.set_verbose_level(0);
+    h5zio.set_num_threads(2);
+    h5zio.open("test_async.h5", "w");
+
+    // passos pares são copiados para o pool, ímpares têm o vetor movido
+    std::vector<std::future<void> > pending;
+    std::vector<double> u(dims[0]*dims[1]);
+    for(int n = 0; n < nsteps; n++)
+    {
+        for(size_t i = 0; i < u.size(); i++)
+        {
+            u[i] = std::sin(0.05 * i + 0.1 * n);
+        }
+        std::string name = "u_" + std::to_string(n);
+        if(n % 2 == 0)
+        {
+            pending.push_back(h5zio.write_dataset_async<double>(name, u.data(), 2, dims, &parameters));
+        }
+        else
+        {
+            std::vector<double> step(u);
+            pending.push_back(h5zio.write_dataset_async<double>(name, std::move(step), 2, dims, &parameters));
+        }
+    }
+
+    // erros da escrita chegam pelo future
+    bool passed = true;
+    std::future<void> duplicated = h5zio.write_dataset_async<double>("u_0", u.data(), 2, dims, &parameters);
+    h5zio.flush();
+    try
+    {
+        duplicated.get();
+        passed = false;
+    }
+    catch(const std::runtime_error&)
+    {
+    }
+    for(auto& write : pending)
+    {
+        write.get();
+    }
+    h5zio.close();
+
+    h5zio.open("test_async.h5", "r");
+    for(int n = 0; passed && n < nsteps; n++)
+    {
+        std::vector<double> step;
+        h5zio.read_dataset<double>("u_" + std::to_string(n), step);
+        passed = step.size() == u.size();
+        for(size_t i = 0; passed && i < step.size(); i++)
+        {
+            passed = step[i] == std::sin(0.05 * i + 0.1 * n);
+        }
+    }
+    h5zio.close();
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
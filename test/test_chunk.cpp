@@ -0,0 +1,84 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "h5zio.h"
+
+int main()
+{
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::ZFP);
+    parameters.set_error_bound_type(H5ZIO::ZFP::ErrorBound::ACCURACY);
+
+    bool passed = true;
+
+    // dataset 3D de 512^3 doubles (1 GB) com chunks de 4 MB
+    hsize_t dims[3] = {512, 512, 512};
+    hsize_t chunk[3];
+    parameters.set_chunk_size(4*1024*1024);
+    parameters.plan_chunk_dimensions(3, dims, sizeof(double), chunk);
+
+    hsize_t chunk_bytes = chunk[0]*chunk[1]*chunk[2]*sizeof(double);
+    std::cout << "Chunk: " << chunk[0] << " x " << chunk[1] << " x " << chunk[2] << std::endl;
+    if(chunk_bytes > 4*1024*1024) passed = false;
+    for(int i = 0; i < 3; i++)
+    {
+        if(chunk[i] % 4 != 0) passed = false;
+    }
+
+    // datasets menores que o tamanho alvo ficam em um único chunk
+    hsize_t small[2] = {100, 100};
+    parameters.plan_chunk_dimensions(2, small, sizeof(double), chunk);
+    if(chunk[0] != 100 || chunk[1] != 100) passed = false;
+
+    // o limite de 4 GB do HDF5 é respeitado no modo de chunk único
+    hsize_t huge[1] = {1ULL << 30};
+    parameters.set_chunk_mode(H5ZIO::ChunkMode::SINGLE);
+    parameters.plan_chunk_dimensions(1, huge, sizeof(double), chunk);
+    if(chunk[0] * sizeof(double) > H5ZIO::MAX_CHUNK_SIZE) passed = false;
+
+    // formato explícito é limitado pelas dimensões do dataset
+    hsize_t explicit_chunk[2] = {64, 256};
+    parameters.set_chunk_dimensions(2, explicit_chunk);
+    parameters.plan_chunk_dimensions(2, small, sizeof(double), chunk);
+    if(chunk[0] != 64 || chunk[1] != 100) passed = false;
+
+    // o limite de 4 GB vale para o chunk explícito em bytes, não em elementos
+    hsize_t big_chunk[1] = {1ULL << 30};
+    parameters.set_chunk_dimensions(1, big_chunk);
+    parameters.plan_chunk_dimensions(1, huge, sizeof(char), chunk);
+    bool rejected = false;
+    try
+    {
+        parameters.plan_chunk_dimensions(1, huge, sizeof(double), chunk);
+    }
+    catch(const std::runtime_error&)
+    {
+        rejected = true;
+    }
+    if(chunk[0] != big_chunk[0] || !rejected) passed = false;
+
+    // cada conjunto de parâmetros guarda os seus valores de erro
+    H5ZIOParameters coarse, fine;
+    coarse.set_compression_type(H5ZIO::Type::ZFP);
+    coarse.set_error_bound_type(H5ZIO::ZFP::ErrorBound::ACCURACY);
+    fine = coarse;
+    coarse.set_error_bound_value(1.0E-2);
+    fine.set_error_bound_value(1.0E-8);
+    if(coarse.get_error_bound_value() != 1.0E-2 || fine.get_error_bound_value() != 1.0E-8) passed = false;
+    if(coarse == fine) passed = false;
+
+    H5ZIOParameters copy(coarse);
+    if(!(copy == coarse) || copy.hash() != coarse.hash()) passed = false;
+    std::unordered_set<H5ZIOParameters> sweep = {coarse, fine, copy};
+    if(sweep.size() != 2) passed = false;
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
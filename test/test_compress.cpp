@@ -0,0 +1,495 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <fstream>
+
+#include "h5zio.h"
+#include "h5zio_tuner.h"
+
+std::string read_attribute(hid_t file_id, const std::string& dataset, const std::string& name)
+{
+    hid_t dataset_id = H5Dopen(file_id, dataset.c_str(), H5P_DEFAULT);
+    hid_t attribute  = H5Aopen(dataset_id, name.c_str(), H5P_DEFAULT);
+    hid_t type       = H5Aget_type(attribute);
+    std::string value(H5Tget_size(type), '\0');
+    H5Aread(attribute, type, &value[0]);
+    H5Tclose(type);
+    H5Aclose(attribute);
+    H5Dclose(dataset_id);
+    return value;
+}
+
+int main()
+{
+    // arquivo de entrada sem compressão
+    hsize_t dims[2] = {300, 200};
+    std::vector<double> f(dims[0]*dims[1]);
+    std::vector<int>    cells(5000);
+    for(size_t i = 0; i < f.size(); i++)
+    {
+        f[i] = std::sin(0.001 * i);
+    }
+    for(size_t i = 0; i < cells.size(); i++)
+    {
+        cells[i] = i / 3;
+    }
+
+    H5Zio input;
+    input.set_verbose_level(0);
+    input.open("test_compress_in.h5", "w");
+    std::vector<std::string> groups = {"/Mesh/", "/Function/"};
+    input.create_groups(groups);
+    input.write_dataset<int>("/Mesh/cells", cells, nullptr);
+    input.write_dataset<double>("/Function/f", f.data(), 2, dims);
+    input.close();
+
+    // limite de memória menor que o dataset: compressão por blocos,
+    // em série e com leitura, compressão e gravação sobrepostas
+    bool passed = true;
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        H5ZIOParameters parameters;
+        parameters.set_compression_type(H5ZIO::Type::GZIP);
+        parameters.set_chunk_size(32*1024);
+        H5ZIO::compress("test_compress_in.h5", "test_compress_out.h5", parameters, 100*1024, nthreads);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_out.h5", "r");
+        std::vector<double> f2;
+        std::vector<int>    cells2;
+        H5Dimensions dims2 = output.read_dataset<double>("/Function/f", f2);
+        output.read_dataset<int>("/Mesh/cells", cells2);
+        output.close();
+
+        passed = passed && dims2.get_ndims() == 2 && dims2[0] == dims[0] && dims2[1] == dims[1] && f2 == f && cells2 == cells;
+    }
+
+    // AUTO: compressor escolhido por amostragem e registrado no atributo h5zio_codec
+    {
+        H5ZIOParameters parameters;
+        parameters.set_compression_type(H5ZIO::Type::AUTO);
+        H5ZIO::compress("test_compress_in.h5", "test_compress_auto.h5", parameters, 100*1024, 1);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_auto.h5", "r");
+        std::vector<double> f2;
+        output.read_dataset<double>("/Function/f", f2);
+
+        std::string codec = read_attribute(output.get_file_id(), "/Function/f", "h5zio_codec");
+        output.close();
+
+        passed = passed && (codec == "ZFP" || codec == "SZ2.1" || codec == "GZIP") && f2.size() == f.size();
+        for(size_t i = 0; passed && i < f.size(); i++)
+        {
+            passed = std::fabs(f2[i] - f[i]) <= 1.0E-5;
+        }
+    }
+
+    // AUTO com vazão mínima: o compressor escolhido codifica a amostra a pelo menos 5 MB/s
+    {
+        H5ZIOParameters parameters;
+        parameters.set_compression_type(H5ZIO::Type::AUTO);
+        parameters.set_min_throughput(5.0);
+        H5ZioTuner tuner;
+        H5ZIOParameters selected = tuner.select_codec<double>(f.data(), 2, dims, parameters);
+        std::cout << "AUTO: " << H5ZIO::compression_type_names[static_cast<int>(selected.get_compression_type())]
+                  << ", ratio " << tuner.get_ratio() << ", " << tuner.get_throughput() << " MB/s" << std::endl;
+
+        passed = passed && tuner.get_throughput() >= parameters.get_min_throughput() && tuner.get_ratio() > 1;
+    }
+
+    // política: inteiros da malha com gzip, campos sem compressão
+    {
+        std::ofstream config("test_compress_policy.txt");
+        config << "compression_type: GZIP" << std::endl;
+        config << "[/Mesh/*]" << std::endl;
+        config << "compression_type: GZIP" << std::endl;
+        config << "[/Function/* float]" << std::endl;
+        config << "compression_type: NONE" << std::endl;
+        config.close();
+
+        H5ZioPolicy policy;
+        policy.load_config("test_compress_policy.txt");
+        H5ZIO::compress("test_compress_in.h5", "test_compress_policy.h5", policy, 100*1024, 1);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_policy.h5", "r");
+        std::vector<double> f2;
+        std::vector<int>    cells2;
+        output.read_dataset<double>("/Function/f", f2);
+        output.read_dataset<int>("/Mesh/cells", cells2);
+
+        int nfilters[2];
+        const char* names[2] = {"/Mesh/cells", "/Function/f"};
+        for(int d = 0; d < 2; d++)
+        {
+            hid_t dataset_id = H5Dopen(output.get_file_id(), names[d], H5P_DEFAULT);
+            hid_t dcpl       = H5Dget_create_plist(dataset_id);
+            nfilters[d] = H5Pget_nfilters(dcpl);
+            H5Pclose(dcpl);
+            H5Dclose(dataset_id);
+        }
+        output.close();
+
+        passed = passed && policy.size() == 2 && nfilters[0] == 1 && nfilters[1] == 0 && f2 == f && cells2 == cells;
+    }
+
+    // verificação na escrita: chunks decodificados e comparados, resumo nos atributos
+    {
+        H5ZIOParameters parameters;
+        parameters.set_compression_type(H5ZIO::Type::GZIP);
+        parameters.set_chunk_size(32*1024);
+        parameters.set_verify(true);
+        H5ZIO::compress("test_compress_in.h5", "test_compress_verify.h5", parameters, 100*1024, 1);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_verify.h5", "r");
+        std::vector<double> f2;
+        output.read_dataset<double>("/Function/f", f2);
+        std::string chunks   = read_attribute(output.get_file_id(), "/Function/f", "h5zio_verified_chunks");
+        std::string lossless = read_attribute(output.get_file_id(), "/Function/f", "h5zio_lossless_chunks");
+        std::string error    = read_attribute(output.get_file_id(), "/Function/f", "h5zio_max_abs_error");
+        output.close();
+
+        passed = passed && std::stoi(chunks) > 1 && lossless == "0" && error == "0" && f2 == f;
+    }
+
+    // verificação de um encadeamento com perdas (scale-offset com 2 casas decimais) sem
+    // codificação direta: os chunks lidos de volta que não são exatos são regravados sem filtros
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        // 60 x 64 com chunks de 16 x 64: linhas inteiras nos 2 primeiros chunks, o último na borda
+        hsize_t chain_dims[2] = {60, 64}, chain_chunk[2] = {16, 64};
+        std::vector<double> g(chain_dims[0]*chain_dims[1]);
+        for(hsize_t i = 0; i < chain_dims[0]; i++)
+        {
+            for(hsize_t j = 0; j < chain_dims[1]; j++)
+            {
+                g[i*chain_dims[1] + j] = i < 32 ? static_cast<double>(i + j) : std::sin(0.1 * i + 0.01 * j);
+            }
+        }
+        H5ZIOParameters scaled;
+        scaled.add_filter(H5ZIO::Filter::SCALEOFFSET, 2).add_filter(H5ZIO::Filter::DEFLATE, 6);
+        scaled.set_chunk_dimensions(2, chain_chunk);
+        scaled.set_verify(true);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.set_num_threads(nthreads);
+        output.open("test_compress_verify_chain.h5", "w");
+        output.write_dataset<double>("g", g.data(), 2, chain_dims, &scaled);
+        output.close();
+
+        output.open("test_compress_verify_chain.h5", "r");
+        std::vector<double> g2;
+        output.read_dataset<double>("g", g2);
+        std::string chunks   = read_attribute(output.get_file_id(), "g", "h5zio_verified_chunks");
+        std::string lossless = read_attribute(output.get_file_id(), "g", "h5zio_lossless_chunks");
+        std::string error    = read_attribute(output.get_file_id(), "g", "h5zio_max_abs_error");
+        output.close();
+
+        passed = passed && chunks == "4" && lossless == "2" && error == "0" && g2 == g;
+    }
+
+    // descompressão: datasets contíguos, sem filtros e com o tipo original
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        H5ZIO::decompress("test_compress_out.h5", "test_compress_plain.h5", nthreads, 100*1024);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_plain.h5", "r");
+        std::vector<double> f2;
+        std::vector<int>    cells2;
+        output.read_dataset<double>("/Function/f", f2);
+        output.read_dataset<int>("/Mesh/cells", cells2);
+
+        const char* names[2] = {"/Mesh/cells", "/Function/f"};
+        for(int d = 0; d < 2; d++)
+        {
+            hid_t dataset_id = H5Dopen(output.get_file_id(), names[d], H5P_DEFAULT);
+            hid_t dcpl       = H5Dget_create_plist(dataset_id);
+            hid_t type       = H5Dget_type(dataset_id);
+            passed = passed && H5Pget_layout(dcpl) == H5D_CONTIGUOUS && H5Pget_nfilters(dcpl) == 0 &&
+                     H5Tequal(type, d == 0 ? H5T_NATIVE_INT : H5T_NATIVE_DOUBLE) > 0;
+            H5Tclose(type);
+            H5Pclose(dcpl);
+            H5Dclose(dataset_id);
+        }
+        output.close();
+
+        passed = passed && f2 == f && cells2 == cells;
+    }
+
+    // inteiros: INTPACK sem perdas e menor que o gzip em índices monótonos e agrupados
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        std::vector<int>  connectivity(100000);
+        std::vector<long> nodes(100000);
+        for(size_t i = 0; i < connectivity.size(); i++)
+        {
+            connectivity[i] = static_cast<int>(i / 4 + (i * 7919) % 13);
+            nodes[i]        = -5000000000L + static_cast<long>(i) * 3;
+        }
+        H5ZIOParameters intpack, gzip;
+        intpack.set_compression_type(H5ZIO::Type::INTPACK);
+        intpack.set_chunk_size(64*1024);
+        gzip.set_compression_type(H5ZIO::Type::GZIP);
+        gzip.set_chunk_size(64*1024);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.set_num_threads(nthreads);
+        output.open("test_compress_intpack.h5", "w");
+        output.write_dataset<int>("connectivity", connectivity, &intpack);
+        output.write_dataset<long>("nodes", nodes, &intpack);
+        output.write_dataset<int>("connectivity_gzip", connectivity, &gzip);
+        output.close();
+
+        output.open("test_compress_intpack.h5", "r");
+        std::vector<int>  connectivity2;
+        std::vector<long> nodes2;
+        output.read_dataset<int>("connectivity", connectivity2);
+        output.read_dataset<long>("nodes", nodes2);
+        hsize_t storage[2];
+        const char* names[2] = {"connectivity", "connectivity_gzip"};
+        for(int d = 0; d < 2; d++)
+        {
+            hid_t dataset_id = H5Dopen(output.get_file_id(), names[d], H5P_DEFAULT);
+            storage[d] = H5Dget_storage_size(dataset_id);
+            H5Dclose(dataset_id);
+        }
+        output.close();
+
+        passed = passed && connectivity2 == connectivity && nodes2 == nodes && storage[0] < storage[1];
+    }
+
+    // INTPACK: larguras de 1 a 64 bits e cabeçalhos corrompidos rejeitados sem falha do processo
+    {
+        std::vector<uint64_t> values(3000);
+        uint64_t state = 88172645463325252ULL;
+        for(size_t i = 0; i < values.size(); i++)
+        {
+            state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+            int bits  = 1 + static_cast<int>((i / H5ZIO::INTPACK_BLOCK) * 13 % 64);
+            values[i] = bits == 64 ? state : state & ((1ULL << bits) - 1);
+        }
+        std::vector<unsigned char> encoded;
+        H5ZIO::intpack_encode(values.data(), values.size(), sizeof(uint64_t), false, encoded);
+        std::vector<uint64_t> decoded(values.size());
+        H5ZIO::intpack_decode(encoded.data(), encoded.size(), decoded.data(), decoded.size() * sizeof(uint64_t));
+        passed = passed && decoded == values;
+
+        // tamanho do elemento, sinal e número de elementos além dos dados
+        unsigned char corrupt[3][2] = {{1, 3}, {2, 2}, {15, 0x7f}};
+        for(auto& field : corrupt)
+        {
+            std::vector<unsigned char> bad(encoded);
+            bad[field[0]] = field[1];
+            bool rejected = false;
+            try
+            {
+                H5ZIO::intpack_decode(bad.data(), bad.size(), decoded.data(), decoded.size() * sizeof(uint64_t));
+            }
+            catch(const std::runtime_error&)
+            {
+                rejected = true;
+            }
+            passed = passed && rejected;
+        }
+    }
+
+    // encadeamentos de filtros: presets, scale-offset de inteiros e configuração em arquivo.
+    // Bits aleatórios não comprimem: os chunks são gravados sem os filtros opcionais
+    std::vector<double> noise(100000);
+    {
+        std::mt19937_64 generator(42);
+        for(auto& value : noise)
+        {
+            uint64_t bits = generator();
+            std::memcpy(&value, &bits, sizeof(double));
+        }
+    }
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        H5ZIOParameters balanced, checked, scaled;
+        balanced.set_filter_preset(H5ZIO::FilterPreset::BALANCED);
+        balanced.set_chunk_size(64*1024);
+        checked.set_filter_preset(H5ZIO::FilterPreset::CHECKED);
+        scaled.add_filter(H5ZIO::Filter::SCALEOFFSET).add_filter(H5ZIO::Filter::SHUFFLE).add_filter(H5ZIO::Filter::DEFLATE, 6);
+
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.set_num_threads(nthreads);
+        output.open("test_compress_chain.h5", "w");
+        output.write_dataset<double>("f", f.data(), 2, dims, &balanced);
+        output.write_dataset<int>("cells", cells, &checked);
+        output.write_dataset<int>("cells_scaled", cells, &scaled);
+        output.write_dataset<double>("noise", noise, &balanced);
+        output.close();
+
+        output.open("test_compress_chain.h5", "r");
+        std::vector<double> f2, noise2;
+        std::vector<int>    cells2, cells3;
+        output.read_dataset<double>("f", f2);
+        output.read_dataset<int>("cells", cells2);
+        output.read_dataset<int>("cells_scaled", cells3);
+        output.read_dataset<double>("noise", noise2);
+        int nfilters[3];
+        const char* names[3] = {"f", "cells", "cells_scaled"};
+        for(int d = 0; d < 3; d++)
+        {
+            hid_t dataset_id = H5Dopen(output.get_file_id(), names[d], H5P_DEFAULT);
+            hid_t dcpl       = H5Dget_create_plist(dataset_id);
+            nfilters[d] = H5Pget_nfilters(dcpl);
+            H5Pclose(dcpl);
+            H5Dclose(dataset_id);
+        }
+        output.close();
+
+        passed = passed && f2 == f && cells2 == cells && cells3 == cells &&
+                 nfilters[0] == 2 && nfilters[1] == 3 && nfilters[2] == 3 &&
+                 noise2.size() == noise.size() && std::memcmp(noise2.data(), noise.data(), noise.size() * sizeof(double)) == 0;
+    }
+    {
+        H5ZIOParameters scaled, loaded;
+        scaled.add_filter(H5ZIO::Filter::SCALEOFFSET).add_filter(H5ZIO::Filter::SHUFFLE).add_filter(H5ZIO::Filter::DEFLATE, 6);
+        scaled.save_config("test_compress_chain.txt");
+        loaded.load_config("test_compress_chain.txt");
+        passed = passed && loaded == scaled && loaded.get_compression_type() == H5ZIO::Type::CHAIN;
+
+        // scale-offset depois do shuffle recebe bytes reordenados
+        bool rejected = false;
+        try
+        {
+            loaded.add_filter(H5ZIO::Filter::SCALEOFFSET);
+        }
+        catch(const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        passed = passed && rejected;
+
+        // scale-offset de doubles sem casas decimais arredondaria os valores para inteiros
+        H5ZIOParameters rounded;
+        rounded.add_filter(H5ZIO::Filter::SCALEOFFSET);
+        H5Zio output;
+        output.set_verbose_level(0);
+        output.open("test_compress_chain.h5", "w");
+        rejected = false;
+        try
+        {
+            output.write_dataset<double>("f", f.data(), 2, dims, &rounded);
+        }
+        catch(const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        output.close();
+        passed = passed && rejected;
+    }
+
+    // tipos sem compressão: copiados com o tipo original; big-endian convertido para o nativo
+    {
+        struct pair_t {int a; double b;};
+        std::vector<double> be(1000);
+        std::vector<pair_t> pairs(10);
+        const char*         names[3] = {"a", "bc", "def"};
+        for(size_t i = 0; i < be.size(); i++)
+        {
+            be[i] = std::cos(0.01 * i);
+        }
+        for(int i = 0; i < 10; i++)
+        {
+            pairs[i].a = i;
+            pairs[i].b = 0.5 * i;
+        }
+        hid_t compound = H5Tcreate(H5T_COMPOUND, sizeof(pair_t));
+        H5Tinsert(compound, "a", HOFFSET(pair_t, a), H5T_NATIVE_INT);
+        H5Tinsert(compound, "b", HOFFSET(pair_t, b), H5T_NATIVE_DOUBLE);
+        hid_t string = H5Tcopy(H5T_C_S1);
+        H5Tset_size(string, H5T_VARIABLE);
+
+        hid_t   file  = H5Fcreate("test_compress_types.h5", H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        hsize_t n[3]  = {be.size(), pairs.size(), 3};
+        hid_t   space = H5Screate_simple(1, &n[0], NULL);
+        hid_t   dset  = H5Dcreate(file, "be", H5T_IEEE_F64BE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, be.data());
+        H5Dclose(dset);
+        H5Sclose(space);
+        space = H5Screate_simple(1, &n[1], NULL);
+        dset  = H5Dcreate(file, "pairs", compound, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(dset, compound, H5S_ALL, H5S_ALL, H5P_DEFAULT, pairs.data());
+        H5Dclose(dset);
+        H5Sclose(space);
+        // strings com filtro: lidas e regravadas sem filtros
+        hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(dcpl, 1, &n[2]);
+        H5Pset_deflate(dcpl, 6);
+        space = H5Screate_simple(1, &n[2], NULL);
+        dset  = H5Dcreate(file, "names", string, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Dwrite(dset, string, H5S_ALL, H5S_ALL, H5P_DEFAULT, names);
+        H5Dclose(dset);
+        H5Sclose(space);
+        H5Pclose(dcpl);
+        H5Fclose(file);
+
+        H5ZIOParameters lossless;
+        lossless.set_compression_type(H5ZIO::Type::GZIP);
+        H5ZIO::compress("test_compress_types.h5", "test_compress_types_out.h5", lossless);
+        H5ZIO::decompress("test_compress_types_out.h5", "test_compress_types_plain.h5", 4);
+
+        const char* files[2] = {"test_compress_types_out.h5", "test_compress_types_plain.h5"};
+        for(int k = 0; k < 2; k++)
+        {
+            std::vector<double> be2(be.size());
+            std::vector<pair_t> pairs2(pairs.size());
+            char*               names2[3] = {nullptr, nullptr, nullptr};
+            file = H5Fopen(files[k], H5F_ACC_RDONLY, H5P_DEFAULT);
+            dset = H5Dopen(file, "be", H5P_DEFAULT);
+            H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, be2.data());
+            H5Dclose(dset);
+            dset = H5Dopen(file, "pairs", H5P_DEFAULT);
+            H5Dread(dset, compound, H5S_ALL, H5S_ALL, H5P_DEFAULT, pairs2.data());
+            H5Dclose(dset);
+            dset = H5Dopen(file, "names", H5P_DEFAULT);
+            H5Dread(dset, string, H5S_ALL, H5S_ALL, H5P_DEFAULT, names2);
+            dcpl = H5Dget_create_plist(dset);
+            bool plain = H5Pget_nfilters(dcpl) == 0;
+            H5Pclose(dcpl);
+            H5Dclose(dset);
+            H5Fclose(file);
+
+            bool same = be2 == be && plain;
+            for(int i = 0; i < 10; i++)
+            {
+                same = same && pairs2[i].a == pairs[i].a && pairs2[i].b == pairs[i].b;
+            }
+            for(int i = 0; i < 3; i++)
+            {
+                same = same && names2[i] != nullptr && std::strcmp(names2[i], names[i]) == 0;
+                free(names2[i]);
+            }
+            std::cout << "Unsupported types copied to " << files[k] << ": " << (same ? "yes" : "no") << std::endl;
+            passed = passed && same;
+        }
+        H5Tclose(string);
+        H5Tclose(compound);
+    }
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
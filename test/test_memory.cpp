@@ -0,0 +1,56 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "h5zio.h"
+
+int main()
+{
+    hsize_t dims[2] = {120, 80};
+    std::vector<double> f(dims[0]*dims[1]);
+    for(size_t i = 0; i < f.size(); i++)
+    {
+        f[i] = std::sin(0.02 * i);
+    }
+
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::GZIP);
+
+    // arquivo construído em memória e exportado como buffer
+    H5Zio h5zio;
+    h5zio.set_verbose_level(0);
+    h5zio.open_memory("test_memory_image.h5");
+    h5zio.write_dataset<double>("f", f.data(), 2, dims, &parameters);
+    std::vector<unsigned char> image = h5zio.get_image();
+    h5zio.close();
+
+    bool passed = !image.empty() && !std::ifstream("test_memory_image.h5").good();
+
+    // leitura direta do buffer
+    std::vector<double> f2;
+    h5zio.open_image(image);
+    h5zio.read_dataset<double>("f", f2);
+    h5zio.close();
+    passed = passed && f2 == f;
+
+    // arquivo em memória gravado em disco no fechamento
+    h5zio.open_memory("test_memory.h5", true);
+    h5zio.write_dataset<double>("f", f.data(), 2, dims, &parameters);
+    h5zio.close();
+
+    std::vector<double> f3;
+    h5zio.open("test_memory.h5", "r");
+    h5zio.read_dataset<double>("f", f3);
+    h5zio.close();
+    passed = passed && f3 == f;
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
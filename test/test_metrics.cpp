@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include "h5zio_metrics.h"
+
+bool close_to(double a, double b)
+{
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+int main()
+{
+    // maior que H5ZIO::METRICS_PARALLEL_THRESHOLD e não múltiplo do bloco
+    size_t n = (1 << 21) + 37;
+    std::vector<float> f(n), g(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        f[i] = 100.0f + 50.0f * std::sin(1e-4 * i);
+        g[i] = f[i] + 1e-3f * std::cos(0.37 * i);
+    }
+
+    // referência escalar em duas passadas
+    double minimum = f[0], maximum = f[0], max_abs = 0.0, max_rel = 0.0, sse = 0.0, sum_x = 0.0, sum_y = 0.0;
+    for(size_t i = 0; i < n; i++)
+    {
+        double error = std::fabs(static_cast<double>(f[i]) - g[i]);
+        minimum = std::min(minimum, static_cast<double>(f[i]));
+        maximum = std::max(maximum, static_cast<double>(f[i]));
+        max_abs = std::max(max_abs, error);
+        max_rel = std::max(max_rel, error / std::fabs(f[i]));
+        sse    += error * error;
+        sum_x  += f[i];
+        sum_y  += g[i];
+    }
+    double mean_x = sum_x / n, mean_y = sum_y / n, sxx = 0.0, syy = 0.0, sxy = 0.0;
+    for(size_t i = 0; i < n; i++)
+    {
+        sxx += (f[i] - mean_x) * (f[i] - mean_x);
+        syy += (g[i] - mean_y) * (g[i] - mean_y);
+        sxy += (f[i] - mean_x) * (g[i] - mean_y);
+    }
+    double rmse    = std::sqrt(sse / n);
+    double pearson = sxy / std::sqrt(sxx * syy);
+
+    H5ZioMetrics serial   = H5ZIO::compute_metrics(f, g, 1);
+    H5ZioMetrics parallel = H5ZIO::compute_metrics(f, g, 4);
+
+    // chunks de tamanhos irregulares acumulados em sequência
+    H5ZioMetrics stream;
+    for(size_t start = 0, length = 1000; start < n; start += length, length = length * 3 / 2)
+    {
+        stream.update(f.data() + start, g.data() + start, std::min(length, n - start));
+    }
+
+    bool passed = true;
+    for(const H5ZioMetrics* metrics : {&serial, &parallel, &stream})
+    {
+        passed = passed && metrics->get_count() == n;
+        passed = passed && metrics->get_min() == minimum && metrics->get_max() == maximum;
+        passed = passed && metrics->get_max_abs_error() == max_abs;
+        passed = passed && close_to(metrics->get_max_rel_error(), max_rel);
+        passed = passed && close_to(metrics->get_rmse(), rmse);
+        passed = passed && close_to(metrics->get_nrmse(), rmse / (maximum - minimum));
+        passed = passed && close_to(metrics->get_psnr(), 20.0 * std::log10((maximum - minimum) / rmse));
+        passed = passed && close_to(metrics->get_pearson(), pearson);
+    }
+
+    // reconstrução exata
+    H5ZioMetrics exact = H5ZIO::compute_metrics(f, f);
+    passed = passed && exact.get_max_abs_error() == 0.0 && exact.get_psnr() == std::numeric_limits<double>::infinity();
+    passed = passed && close_to(exact.get_pearson(), 1.0);
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#include "h5zio.h"
+
+int main()
+{
+    // campo 3D com dimensões que não são múltiplas do chunk
+    hsize_t dims[3] = {37, 50, 61};
+    std::vector<double> f(dims[0]*dims[1]*dims[2]);
+    for(size_t i = 0; i < f.size(); i++)
+    {
+        f[i] = std::sin(0.01 * i) * std::cos(0.003 * i);
+    }
+
+    H5Zio h5zio;
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::GZIP);
+    parameters.set_chunk_size(64*1024);
+
+    H5ZioTrace::enable();
+    h5zio.set_verbose_level(1);
+    h5zio.set_num_threads(4);
+    h5zio.open("test_parallel.h5", "w");
+    h5zio.write_dataset<double>("f", f.data(), 3, dims, &parameters);
+    h5zio.close();
+
+    // leitura pelo filtro deflate do HDF5 e pela decodificação paralela
+    std::vector<double> f2, f3;
+    h5zio.set_num_threads(1);
+    h5zio.open("test_parallel.h5", "r");
+    h5zio.read_dataset<double>("f", f2);
+    h5zio.close();
+
+    h5zio.set_num_threads(4);
+    h5zio.open("test_parallel.h5", "r");
+    h5zio.read_dataset<double>("f", f3);
+    h5zio.close();
+
+    bool passed = f2.size() == f.size() && f3.size() == f.size();
+    for(size_t i = 0; passed && i < f.size(); i++)
+    {
+        passed = f[i] == f2[i] && f[i] == f3[i];
+    }
+
+    // estatísticas da escrita paralela e das duas leituras do dataset
+    H5ZioDatasetStats written = h5zio.get_stats().get_dataset("/f");
+    H5ZioDatasetStats read    = h5zio.get_stats().get_dataset("/f", "read");
+    passed = passed && written.calls == 1 && written.raw_bytes == f.size() * sizeof(double) &&
+             written.stored_bytes > 0 && written.get_ratio() > 1.0 && written.peak_buffer_bytes > 0 &&
+             written.compression_seconds > 0.0 && written.wall_seconds >= written.setup_seconds + written.io_seconds;
+    passed = passed && read.calls == 2 && read.raw_bytes == 2 * f.size() * sizeof(double) && read.compression_seconds > 0.0;
+    h5zio.get_stats().save("test_parallel_stats.json");
+    H5ZioTrace::disable();
+#ifdef H5ZIO_HAS_TRACE
+    passed = passed && H5ZioTrace::recorded() > 0;
+#endif
+    H5ZioTrace::save("test_parallel_trace.json");
+
+    // fatia k = 30 e sub-bloco com passo 2, em série e em paralelo
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        h5zio.set_num_threads(nthreads);
+        h5zio.open("test_parallel.h5", "r");
+        std::vector<double> slice = h5zio.read_region<double>("f", {0, 0, 30}, {dims[0], dims[1], 1});
+        std::vector<double> block = h5zio.read_region<double>("f", {5, 7, 9}, {10, 20, 25}, {2, 1, 2});
+        h5zio.close();
+
+        for(hsize_t i = 0; passed && i < dims[0]; i++)
+            for(hsize_t j = 0; passed && j < dims[1]; j++)
+                passed = slice[i*dims[1] + j] == f[(i*dims[1] + j)*dims[2] + 30];
+
+        for(hsize_t i = 0; passed && i < 10; i++)
+            for(hsize_t j = 0; passed && j < 20; j++)
+                for(hsize_t k = 0; passed && k < 25; k++)
+                    passed = block[(i*20 + j)*25 + k] == f[((5 + 2*i)*dims[1] + 7 + j)*dims[2] + 9 + 2*k];
+    }
+
+    // leitura em buffers do pool: o segundo campo reaproveita o buffer do primeiro
+    for(unsigned int nthreads = 1; passed && nthreads <= 4; nthreads += 3)
+    {
+        h5zio.set_num_threads(nthreads);
+        h5zio.open("test_parallel.h5", "r");
+        const double* first = nullptr;
+        for(int step = 0; passed && step < 2; step++)
+        {
+            H5ZioView<double> view = h5zio.read_view<double>("f");
+            passed = view.size() == f.size() && view.get_dims().size() == 3 && view.get_dims()[2] == dims[2] &&
+                     reinterpret_cast<uintptr_t>(view.data()) % H5ZIO::BUFFER_ALIGNMENT == 0;
+            for(size_t i = 0; passed && i < f.size(); i++)
+            {
+                passed = view[i] == f[i];
+            }
+            if(step == 0) first = view.data();
+            else passed = passed && view.data() == first;
+        }
+        h5zio.close();
+    }
+
+    // deflate medido no caminho de chunks diretos: uma execução por chunk
+    {
+        H5Zio timed;
+        timed.set_verbose_level(0);
+        timed.set_num_threads(4);
+        timed.set_filter_timing(true);
+        timed.open("test_filter_timing.h5", "w");
+        timed.write_dataset<double>("f", f.data(), 3, dims, &parameters);
+        timed.close();
+        std::vector<double> f4;
+        timed.open("test_filter_timing.h5", "r");
+        timed.read_dataset<double>("f", f4);
+        timed.close();
+
+        H5ZioDatasetStats written = timed.get_stats().get_dataset("/f");
+        H5ZioDatasetStats read    = timed.get_stats().get_dataset("/f", "read");
+        passed = passed && f4 == f && !H5ZioFilterTimer::is_installed(H5Z_FILTER_DEFLATE) && written.filter_chunks > 1 &&
+                 written.filter_input_bytes >= f.size() * sizeof(double) && written.filter_output_bytes == written.stored_bytes &&
+                 written.filter_seconds > 0.0 && written.filter_seconds <= written.compression_seconds;
+        passed = passed && read.filter_chunks == written.filter_chunks && read.filter_input_bytes == written.filter_output_bytes &&
+                 read.filter_output_bytes == written.filter_input_bytes && read.max_chunk_seconds > 0.0 &&
+                 read.filter_seconds <= read.compression_seconds;
+
+        // filtro do h5zio dentro de H5Dwrite: a classe é registrada de novo com H5Zregister
+        timed.set_num_threads(1);
+        std::vector<int> counts(64*1024);
+        for(size_t i = 0; i < counts.size(); i++) counts[i] = static_cast<int>(i % 1000);
+        hsize_t counts_dims[1] = {counts.size()};
+        H5ZIOParameters packed;
+        packed.set_compression_type(H5ZIO::Type::INTPACK);
+        packed.set_chunk_size(64*1024);
+        timed.open("test_filter_timing.h5", "w");
+        timed.write_dataset<int>("counts", counts.data(), 1, counts_dims, &packed);
+        timed.close();
+        H5ZioDatasetStats intpack = timed.get_stats().get_dataset("/counts");
+        passed = passed && H5ZioFilterTimer::is_installed(H5ZIO::FILTER_INTPACK) && intpack.filter_chunks == 4 &&
+                 intpack.filter_input_bytes == counts.size() * sizeof(int) && intpack.filter_output_bytes == intpack.stored_bytes;
+
+        // desligada, a classe original é registrada de volta
+        timed.set_filter_timing(false);
+        timed.get_stats().clear();
+        std::vector<int> counts2;
+        timed.open("test_filter_timing.h5", "r");
+        timed.read_dataset<int>("counts", counts2);
+        timed.close();
+        passed = passed && counts2 == counts && !H5ZioFilterTimer::is_installed(H5ZIO::FILTER_INTPACK) &&
+                 timed.get_stats().get_dataset("/counts", "read").filter_chunks == 0;
+    }
+
+    // datasets contíguos são mapeados do arquivo; comprimidos e com conversão de tipo são copiados
+    std::vector<int> ids(1000);
+    for(size_t i = 0; i < ids.size(); i++) ids[i] = 3*i + 1;
+    hsize_t ids_dims[1] = {ids.size()};
+    h5zio.open("test_mmap.h5", "w");
+    h5zio.write_dataset<int>("ids", ids.data(), 1, ids_dims);
+    h5zio.write_dataset<double>("f", f.data(), 3, dims, &parameters);
+    h5zio.close();
+
+    h5zio.open("test_mmap.h5", "r");
+    {
+        H5ZioView<const int>    mapped    = h5zio.map_view<int>("ids");
+        H5ZioView<const double> converted = h5zio.map_view<double>("ids");
+        H5ZioView<const double> copied    = h5zio.map_view<double>("f");
+        passed = passed && mapped.is_mapped() && !converted.is_mapped() && !copied.is_mapped() &&
+                 mapped.size() == ids.size() && copied.size() == f.size();
+        for(size_t i = 0; passed && i < ids.size(); i++)
+        {
+            passed = mapped[i] == ids[i] && converted[i] == ids[i];
+        }
+        for(size_t i = 0; passed && i < f.size(); i++)
+        {
+            passed = copied[i] == f[i];
+        }
+    }
+    h5zio.close();
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
@@ -45,14 +45,54 @@ int main()
     std::cout << "L2 norm of the error: "       << l2_error << std::endl;
     std::cout << "Infinity norm of the error: " << inf_error << std::endl;
 
-    if(inf_error < acc)
+    bool passed = inf_error < acc;
+
+    // chunks codificados pelo pool e pelo filtro registrado, incluindo os da borda
+    hsize_t chunk[2] = {32, 32};
+    parameters.set_chunk_dimensions(2, chunk);
+    passed = check_chunk_paths("test_sz", f, 100, 100, parameters) && passed;
+
+    // verificação com limite relativo: o SZ usa a amplitude do chunk completado com 
+    // zeros, e os chunks da borda não devem ser considerados violações
     {
-        std::cout << "Test passed" << std::endl;
+        hsize_t g_dims[2] = {50, 50}, g_chunk[2] = {16, 16};
+        std::vector<double> g(g_dims[0]*g_dims[1]), g2;
+        for(size_t i = 0; i < g.size(); i++)
+        {
+            g[i] = 1000.0 + std::sin(0.01 * i);
+        }
+        H5ZIOParameters relative;
+        relative.set_compression_type(H5ZIO::Type::SZ2);
+        relative.set_error_bound_type(H5ZIO::SZ2::ErrorBound::RELATIVE);
+        relative.set_error_bound_value(1.0E-4);
+        relative.set_chunk_dimensions(2, g_chunk);
+        relative.set_verify(true);
+
+        h5zio.open("test.h5", "w");
+        h5zio.write_dataset<double>("g", g.data(), 2, g_dims, &relative);
+        h5zio.close();
+
+        h5zio.open("test.h5", "r");
+        h5zio.read_dataset<double>("g", g2);
+        hid_t dataset_id = H5Dopen(h5zio.get_file_id(), "g", H5P_DEFAULT);
+        hid_t attribute  = H5Aopen(dataset_id, "h5zio_lossless_chunks", H5P_DEFAULT);
+        hid_t type       = H5Aget_type(attribute);
+        std::string lossless(H5Tget_size(type), '\0');
+        H5Aread(attribute, type, &lossless[0]);
+        H5Tclose(type);
+        H5Aclose(attribute);
+        H5Dclose(dataset_id);
+        h5zio.close();
+
+        std::cout << "Relative bound, chunks stored losslessly: " << lossless << std::endl;
+        passed = passed && lossless == "0" && g2.size() == g.size();
     }
-    else
+
+    if(passed)
     {
-        std::cout << "Test failed" << std::endl;
+        std::cout << "Test passed" << std::endl;
+        return 0;
     }
-
-    return 0;
+    std::cout << "Test failed" << std::endl;
+    return 1;
 } 
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "h5zio.h"
+
+int main()
+{
+    hsize_t dims[2] = {40, 30};
+    int nsteps = 5;
+
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::GZIP);
+
+    bool passed = true;
+    for(unsigned int nthreads = 1; nthreads <= 4; nthreads += 3)
+    {
+        H5Zio h5zio;
+        h5zio.set_verbose_level(0);
+        h5zio.set_num_threads(nthreads);
+        h5zio.open("test_timeseries.h5", "w");
+        h5zio.create_timeseries<double>("u", 2, dims, &parameters);
+
+        // um campo por passo de tempo
+        std::vector<double> u(dims[0]*dims[1]);
+        for(int n = 0; n < nsteps; n++)
+        {
+            for(size_t i = 0; i < u.size(); i++)
+            {
+                u[i] = std::sin(0.05 * i + 0.1 * n);
+            }
+            h5zio.append<double>("u", u);
+        }
+        h5zio.close();
+
+        h5zio.open("test_timeseries.h5", "r");
+        H5Dimensions shape = h5zio.dataset_dimensions("u");
+        passed = passed && shape.get_ndims() == 3 && shape[0] == nsteps;
+        for(int n = 0; passed && n < nsteps; n++)
+        {
+            std::vector<double> step = h5zio.read_region<double>("u", {(hsize_t) n, 0, 0}, {1, dims[0], dims[1]});
+            for(size_t i = 0; passed && i < step.size(); i++)
+            {
+                passed = step[i] == std::sin(0.05 * i + 0.1 * n);
+            }
+        }
+        h5zio.close();
+    }
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
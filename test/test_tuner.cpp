@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "h5zio.h"
+#include "h5zio_tuner.h"
+
+// PSNR do array completo em dB, com a amplitude dos dados originais
+double compute_psnr(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double minimum = a[0], maximum = a[0], mse = 0.0;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        minimum = std::min(minimum, a[i]);
+        maximum = std::max(maximum, a[i]);
+        mse    += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    mse /= a.size();
+    return 20.0 * std::log10(maximum - minimum) - 10.0 * std::log10(mse);
+}
+
+int main()
+{
+    // campo suave de 512 x 512 doubles (2 MB): a amostra é uma fração do array
+    hsize_t dims[2] = {512, 512};
+    std::vector<double> f(dims[0]*dims[1]);
+    for(hsize_t i = 0; i < dims[0]; i++)
+    {
+        for(hsize_t j = 0; j < dims[1]; j++)
+        {
+            f[i*dims[1] + j] = std::sin(0.02 * i) * std::cos(0.03 * j) + 0.1 * std::sin(0.7 * i * j);
+        }
+    }
+
+    H5ZIOParameters parameters;
+    parameters.set_compression_type(H5ZIO::Type::ZFP);
+    parameters.set_error_bound_type(H5ZIO::ZFP::ErrorBound::ACCURACY);
+    parameters.set_chunk_size(256*1024);
+
+    bool passed = true;
+    H5Zio h5zio;
+    h5zio.set_verbose_level(0);
+    h5zio.open("test_tuner.h5", "w");
+
+    // PSNR alvo: atingido na amostra e, com folga, no array completo
+    {
+        H5ZioTuner tuner;
+        H5ZIOParameters tuned = tuner.tune<double>(f.data(), 2, dims, parameters, H5ZIO::Target::PSNR, 60.0);
+        h5zio.write_dataset<double>("psnr", f.data(), 2, dims, &tuned);
+
+        std::vector<double> f2;
+        h5zio.read_dataset<double>("psnr", f2);
+        double full_psnr = compute_psnr(f, f2);
+        std::cout << "PSNR: bound " << tuner.get_bound() << ", sample " << tuner.get_psnr()
+                  << " dB, full " << full_psnr << " dB, " << tuner.get_iterations() << " iterations" << std::endl;
+
+        passed = passed && tuned.get_error_bound_value() > 0 && tuner.get_iterations() <= 8 &&
+                 std::fabs(tuner.get_psnr() - 60.0) <= 0.1 * 60.0 && std::fabs(full_psnr - 60.0) <= 0.2 * 60.0;
+    }
+
+    // taxa de compressão alvo
+    {
+        H5ZioTuner tuner;
+        H5ZIOParameters tuned = tuner.tune<double>(f.data(), 2, dims, parameters, H5ZIO::Target::RATIO, 10.0);
+        h5zio.write_dataset<double>("ratio", f.data(), 2, dims, &tuned);
+
+        hid_t   dataset_id = H5Dopen(h5zio.get_file_id(), "ratio", H5P_DEFAULT);
+        double  full_ratio = static_cast<double>(f.size() * sizeof(double)) / H5Dget_storage_size(dataset_id);
+        H5Dclose(dataset_id);
+        std::cout << "Ratio: bound " << tuner.get_bound() << ", sample " << tuner.get_ratio()
+                  << ", full " << full_ratio << ", " << tuner.get_iterations() << " iterations" << std::endl;
+
+        passed = passed && tuned.get_error_bound_value() > 0 && tuner.get_iterations() <= 8 &&
+                 std::fabs(tuner.get_ratio() - 10.0) <= 0.15 * 10.0 && std::fabs(full_ratio - 10.0) <= 0.3 * 10.0;
+    }
+
+    // dados constantes: um limite positivo, sem busca, e reconstrução exata
+    {
+        std::vector<double> constant(f.size(), 3.5);
+        H5ZioTuner tuner;
+        H5ZIOParameters tuned = tuner.tune<double>(constant.data(), 2, dims, parameters, H5ZIO::Target::PSNR, 60.0);
+        h5zio.write_dataset<double>("constant", constant.data(), 2, dims, &tuned);
+
+        std::vector<double> constant2;
+        h5zio.read_dataset<double>("constant", constant2);
+        double error = 0.0;
+        for(size_t i = 0; i < constant.size(); i++)
+        {
+            error = std::max(error, std::fabs(constant2[i] - constant[i]));
+        }
+
+        passed = passed && tuned.get_error_bound_value() > 0 && tuner.get_iterations() == 1 &&
+                 tuner.get_ratio() > 1 && error <= tuned.get_error_bound_value();
+    }
+    h5zio.close();
+
+    if(passed)
+    {
+        std::cout << "Test passed" << std::endl;
+        return 0;
+    }
+    std::cout << "Test failed" << std::endl;
+    return 1;
+}
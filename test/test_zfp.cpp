@@ -53,14 +53,16 @@ int main()
     std::cout << "L2 norm of the error: "       << l2_error << std::endl;
     std::cout << "Infinity norm of the error: " << inf_error << std::endl;
 
-    if(inf_error < acc)
+    // chunks codificados pelo pool e pelo filtro registrado, incluindo os da borda
+    hsize_t chunk[2] = {32, 32};
+    parameters.set_chunk_dimensions(2, chunk);
+    bool paths = check_chunk_paths("test_zfp", f, 100, 100, parameters);
+
+    if(inf_error < acc && paths)
     {
         std::cout << "Test passed" << std::endl;
+        return 0;
     }
-    else
-    {
-        std::cout << "Test failed" << std::endl;
-    }
-
-    return 0;
+    std::cout << "Test failed" << std::endl;
+    return 1;
 } 
\ No newline at end of file